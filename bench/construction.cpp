@@ -0,0 +1,97 @@
+#include <benchmark/benchmark.h>
+
+#include <argparse/argparse.hpp>
+
+#include <string>
+#include <vector>
+
+static std::vector<std::string> make_names(std::size_t count,
+                                           const std::string &prefix) {
+  std::vector<std::string> names;
+  names.reserve(count);
+  for (std::size_t i = 0; i < count; ++i)
+    names.push_back(prefix + std::to_string((i * 7919) % count));
+  return names;
+}
+
+static void BM_AddArgument(benchmark::State &state) {
+  const auto names =
+      make_names(static_cast<std::size_t>(state.range(0)), "--option-");
+  for (auto _ : state) {
+    argparse::ArgumentParser parser("bench");
+    for (const auto &name : names)
+      parser.add_argument<int>(name);
+    benchmark::DoNotOptimize(parser);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_AddArgument)
+    ->RangeMultiplier(10)
+    ->Range(10, 10000)
+    ->Complexity();
+
+static void BM_AddArgumentAndFreeze(benchmark::State &state) {
+  const auto names =
+      make_names(static_cast<std::size_t>(state.range(0)), "--option-");
+  for (auto _ : state) {
+    argparse::ArgumentParser parser("bench");
+    for (const auto &name : names)
+      parser.add_argument<int>(name);
+    parser.freeze();
+    benchmark::DoNotOptimize(parser);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_AddArgumentAndFreeze)
+    ->RangeMultiplier(10)
+    ->Range(10, 10000)
+    ->Complexity();
+
+static void BM_AddSubcommand(benchmark::State &state) {
+  const auto names =
+      make_names(static_cast<std::size_t>(state.range(0)), "command-");
+  for (auto _ : state) {
+    argparse::ArgumentParser parser("bench");
+    for (const auto &name : names)
+      parser.add_subcommand(name, "");
+    benchmark::DoNotOptimize(parser);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_AddSubcommand)
+    ->RangeMultiplier(10)
+    ->Range(10, 10000)
+    ->Complexity();
+
+static void add_options(argparse::ArgumentParser &parser) {
+  for (int i = 0; i < 20; ++i)
+    parser.add_argument<int>("--option-" + std::to_string(i))
+        .help("option " + std::to_string(i));
+}
+
+static void BM_EagerSubcommands(benchmark::State &state) {
+  const auto names   = make_names(120, "command-");
+  const char *argv[] = {"bench", "command-42", "--option-3", "7"};
+  for (auto _ : state) {
+    argparse::ArgumentParser parser("bench");
+    for (const auto &name : names)
+      add_options(parser.add_subcommand(name, "run " + name));
+    benchmark::DoNotOptimize(parser.parse_args(4, argv));
+  }
+}
+BENCHMARK(BM_EagerSubcommands);
+
+static void BM_LazySubcommands(benchmark::State &state) {
+  const auto names   = make_names(120, "command-");
+  const char *argv[] = {"bench", "command-42", "--option-3", "7"};
+  for (auto _ : state) {
+    argparse::ArgumentParser parser("bench");
+    for (const auto &name : names)
+      parser.add_subcommand(name, "run " + name, add_options);
+    benchmark::DoNotOptimize(parser.parse_args(4, argv));
+  }
+}
+BENCHMARK(BM_LazySubcommands);
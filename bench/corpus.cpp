@@ -0,0 +1,100 @@
+#include <benchmark/benchmark.h>
+
+#include <argparse/argparse.hpp>
+
+#include <string>
+#include <vector>
+
+namespace {
+struct Corpus {
+  argparse::ArgumentParser parser;
+  std::vector<std::string> tokens;
+  std::vector<const char *> argv;
+
+  Corpus() : parser("bench") {}
+  void finish() {
+    argv.push_back("bench");
+    for (const auto &token : tokens)
+      argv.push_back(token.c_str());
+    parser.freeze();
+  }
+};
+
+void compiler(Corpus &corpus) {
+  auto &parser = corpus.parser;
+  parser.add_argument<std::string>("-O").default_value("0");
+  parser.add_argument("-g");
+  parser.add_argument("-c");
+  parser.add_argument<std::string>("-o", "--output");
+  parser.add_argument<std::vector<std::string>>("-I", "--include").nargs(1);
+  parser.add_argument<std::vector<std::string>>("-D", "--define").nargs(1);
+  parser.add_argument<std::vector<std::string>>("-W", "--warning").nargs(1);
+  parser.add_argument<std::string>("--std").default_value("c++17");
+  parser.add_argument<std::vector<std::string>>("sources");
+
+  corpus.tokens = {"-O2",         "-g",          "-Wall",      "-Wextra",
+                   "-I",          "include",     "-I/usr/include/fmt",
+                   "-DNDEBUG",    "-D",          "VERSION=3",  "--std=c++20",
+                   "-c",          "-o",          "build/main.o",
+                   "src/main.cpp"};
+}
+
+void vcs(Corpus &corpus) {
+  auto &parser = corpus.parser;
+  parser.add_argument("-v", "--verbose");
+  parser.add_argument<std::string>("-C").help("run as if started in <path>");
+  auto &commit = parser.add_subcommand("commit", "record changes");
+  commit.add_argument("-a", "--all");
+  commit.add_argument<std::string>("-m", "--message");
+  commit.add_argument<std::string>("--author");
+  commit.add_argument("--amend");
+  for (const char *name : {"add", "log", "push", "pull", "status", "tag"})
+    parser.add_subcommand(name, std::string{name} + " changes")
+        .add_argument("-v", "--verbose");
+
+  corpus.tokens = {"-C", "/src/project", "commit", "-a", "-m",
+                   "Fix the frobnicator", "--author=A U Thor <a@example.com>"};
+}
+
+void batch(Corpus &corpus) {
+  auto &parser = corpus.parser;
+  parser.add_argument<int>("-j", "--jobs").default_value(1);
+  parser.add_argument<std::string>("--format").default_value("json");
+  parser.add_argument<std::vector<int>>("--shards").nargs(1);
+  parser.add_argument<std::vector<std::string>>("inputs");
+
+  corpus.tokens = {"-j", "16", "--format", "csv", "--shards", "1,2,3,4,5,6"};
+  for (int i = 0; i < 2000; ++i)
+    corpus.tokens.push_back("/data/2024/part-" + std::to_string(i) +
+                            ".parquet");
+}
+} // namespace
+
+static void BM_ParseCorpus(benchmark::State &state, void (*shape)(Corpus &)) {
+  Corpus corpus;
+  shape(corpus);
+  corpus.finish();
+  const int argc = static_cast<int>(corpus.argv.size());
+  for (auto _ : state)
+    benchmark::DoNotOptimize(
+        corpus.parser.parse_args(argc, corpus.argv.data()));
+  state.SetItemsProcessed(state.iterations() * (argc - 1));
+}
+BENCHMARK_CAPTURE(BM_ParseCorpus, compiler, compiler);
+BENCHMARK_CAPTURE(BM_ParseCorpus, vcs, vcs);
+BENCHMARK_CAPTURE(BM_ParseCorpus, batch, batch);
+
+static void BM_ParseCorpusTyped(benchmark::State &state,
+                                void (*shape)(Corpus &)) {
+  Corpus corpus;
+  shape(corpus);
+  corpus.finish();
+  const int argc = static_cast<int>(corpus.argv.size());
+  for (auto _ : state)
+    benchmark::DoNotOptimize(
+        corpus.parser.parse_typed(argc, corpus.argv.data()));
+  state.SetItemsProcessed(state.iterations() * (argc - 1));
+}
+BENCHMARK_CAPTURE(BM_ParseCorpusTyped, compiler, compiler);
+BENCHMARK_CAPTURE(BM_ParseCorpusTyped, vcs, vcs);
+BENCHMARK_CAPTURE(BM_ParseCorpusTyped, batch, batch);
@@ -0,0 +1,48 @@
+#include <benchmark/benchmark.h>
+
+#include <argparse/argparse.hpp>
+
+#include <string>
+
+static void populate(argparse::ArgumentParser &parser, std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i)
+    parser
+        .add_argument<int>("-o" + std::to_string(i),
+                           "--option-" + std::to_string(i))
+        .help("configures option number " + std::to_string(i) +
+              " of the benchmark tool, with a description long enough to "
+              "wrap onto a second line")
+        .group(i % 3 == 0 ? "" : "Group " + std::to_string(i % 3));
+}
+
+static void BM_RenderHelp(benchmark::State &state) {
+  argparse::ArgumentParser parser("bench");
+  populate(parser, static_cast<std::size_t>(state.range(0)));
+  std::size_t generation = 0;
+  for (auto _ : state) {
+    parser.description(std::to_string(++generation));
+    benchmark::DoNotOptimize(parser.help().data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RenderHelp)->Arg(10)->Arg(100)->Arg(900);
+
+static void BM_CachedHelp(benchmark::State &state) {
+  argparse::ArgumentParser parser("bench");
+  populate(parser, static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state)
+    benchmark::DoNotOptimize(parser.help().data());
+}
+BENCHMARK(BM_CachedHelp)->Arg(10)->Arg(100)->Arg(900);
+
+static void BM_RenderUsage(benchmark::State &state) {
+  argparse::ArgumentParser parser("bench");
+  populate(parser, static_cast<std::size_t>(state.range(0)));
+  std::size_t generation = 0;
+  for (auto _ : state) {
+    parser.epilog(std::to_string(++generation));
+    benchmark::DoNotOptimize(parser.usage().data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RenderUsage)->Arg(10)->Arg(100)->Arg(900);
@@ -0,0 +1,396 @@
+#include <benchmark/benchmark.h>
+
+#include <argparse/argparse.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <regex>
+
+namespace {
+
+template <typename T> void legacy_parse(const std::string &text, T &value) {
+  static const std::basic_regex<char> integer_pattern(
+      "(-)?(0x|0X|0b|0)?([0-9a-zA-Z]+)|((0x|0X|0b)?0)");
+  using US = typename std::make_unsigned<T>::type;
+
+  std::smatch match;
+  std::regex_match(text, match, integer_pattern);
+  if (match.length() == 0)
+    throw argparse::argument_incorrect_type{text};
+
+  const bool negative = match[1].length() > 0;
+  US base             = 10;
+  if (match[2] == "0x" || match[2] == "0X")
+    base = 16;
+  else if (match[2] == "0")
+    base = 8;
+  else if (match[2] == "0b")
+    base = 2;
+
+  US result = 0;
+  for (char ch : match[3].str()) {
+    US digit = 0;
+    if (ch >= '0' && ch <= '9')
+      digit = static_cast<US>(ch - '0');
+    else if (ch >= 'a' && ch <= 'f')
+      digit = static_cast<US>(ch - 'a' + 10);
+    else if (ch >= 'A' && ch <= 'F')
+      digit = static_cast<US>(ch - 'A' + 10);
+    if (digit >= base || (std::numeric_limits<US>::max() - digit) / base < result)
+      throw argparse::argument_incorrect_type{text};
+    result = static_cast<US>(result * base + digit);
+  }
+  value = negative ? static_cast<T>(-static_cast<T>(result - 1) - 1)
+                   : static_cast<T>(result);
+}
+
+std::string to_base(int value, int base) {
+  char buf[40];
+  auto res = std::to_chars(buf, buf + sizeof(buf), std::abs(value), base);
+  return std::string(buf, res.ptr);
+}
+
+std::vector<std::string> integer_corpus(std::size_t n) {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> dist(-1000000, 1000000);
+  std::vector<std::string> corpus;
+  corpus.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    const int v = dist(gen);
+    if (i % 4 == 0)
+      corpus.push_back(std::to_string(v));
+    else if (i % 4 == 1)
+      corpus.push_back((v < 0 ? "-0x" : "0x") + to_base(v, 16));
+    else if (i % 4 == 2)
+      corpus.push_back((v < 0 ? "-0" : "0") + to_base(v, 8));
+    else
+      corpus.push_back((v < 0 ? "-0b" : "0b") + to_base(v, 2));
+  }
+  return corpus;
+}
+
+} // namespace
+
+static void BM_ParseInteger(benchmark::State &state) {
+  const auto corpus = integer_corpus(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    for (const auto &text : corpus) {
+      int value = 0;
+      argparse::parse(text, value);
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ParseInteger)->Arg(1 << 10)->Arg(1 << 17);
+
+static void BM_ParseIntegerLegacy(benchmark::State &state) {
+  const auto corpus = integer_corpus(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    for (const auto &text : corpus) {
+      int value = 0;
+      legacy_parse(text, value);
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ParseIntegerLegacy)->Arg(1 << 10)->Arg(1 << 17);
+
+static void BM_ParseIntegerList(benchmark::State &state) {
+  std::string text;
+  for (std::int64_t i = 0; i < state.range(0); ++i)
+    text += std::to_string(i) + ",";
+  for (auto _ : state) {
+    std::vector<int> value;
+    argparse::parse(text, value);
+    benchmark::DoNotOptimize(value.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ParseIntegerList)->Arg(1 << 10)->Arg(1 << 20);
+
+template <typename T>
+static void BM_ParseFloatingPoint(benchmark::State &state) {
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<T> dist(-1e6, 1e6);
+  std::vector<std::string> corpus;
+  for (std::int64_t i = 0; i < state.range(0); ++i)
+    corpus.push_back(std::to_string(dist(gen)));
+  for (auto _ : state) {
+    for (const auto &text : corpus) {
+      T value = 0;
+      argparse::parse(text, value);
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_ParseFloatingPoint, float)->Arg(1 << 10);
+BENCHMARK_TEMPLATE(BM_ParseFloatingPoint, double)->Arg(1 << 10);
+
+static void BM_ParseDoubleStream(benchmark::State &state) {
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> dist(-1e6, 1e6);
+  std::vector<std::string> corpus;
+  for (std::int64_t i = 0; i < state.range(0); ++i)
+    corpus.push_back(std::to_string(dist(gen)));
+  for (auto _ : state) {
+    for (const auto &text : corpus) {
+      double value = 0;
+      std::stringstream in(text);
+      in >> value;
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ParseDoubleStream)->Arg(1 << 10);
+
+static void BM_ParseManyOptions(benchmark::State &state) {
+  argparse::ArgumentParser parser("bench");
+  for (std::int64_t i = 0; i < state.range(0); ++i) {
+    auto &arg = parser.add_argument<int>("--option-" + std::to_string(i));
+    if (i % 4 == 0)
+      arg.default_value(static_cast<int>(i));
+  }
+  parser.add_argument<std::string>("input");
+  parser.freeze();
+
+  const char *argv[] = {"bench",       "--option-1", "1", "--option-7",
+                        "7",           "--option-9", "9", "--option-2=2",
+                        "input.txt"};
+  for (auto _ : state)
+    benchmark::DoNotOptimize(parser.parse_typed(9, argv));
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_ParseManyOptions)
+    ->RangeMultiplier(10)
+    ->Range(10, 10000)
+    ->Complexity();
+
+static void BM_ParseCommandLine(benchmark::State &state) {
+  argparse::ArgumentParser parser("bench");
+  parser.add_argument("-v", "--verbose");
+  parser.add_argument<int>("-j", "--jobs");
+  parser.add_argument<std::vector<int>>("--ids");
+  parser.add_argument<std::string>("inputs").nargs('+');
+  parser.freeze();
+
+  const char *argv[] = {"bench", "-v",    "-j",    "8",    "a.txt",
+                        "b.txt", "c.txt", "--ids", "1,2,3"};
+  alignas(std::max_align_t) std::byte buffer[1 << 12];
+  std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer));
+  std::pmr::memory_resource *resource =
+      state.range(0) != 0 ? &arena : std::pmr::get_default_resource();
+  for (auto _ : state) {
+    {
+      argparse::TypedResult values = parser.parse_typed(9, argv, resource);
+      benchmark::DoNotOptimize(values);
+    }
+    arena.release();
+  }
+}
+BENCHMARK(BM_ParseCommandLine)->ArgName("arena")->Arg(0)->Arg(1);
+
+static const argparse::ArgumentParser &control_parser() {
+  static const auto parser = [] {
+    auto res = std::make_unique<argparse::ArgumentParser>("control");
+    res->add_argument("-v", "--verbose");
+    res->add_argument<int>("-p", "--priority");
+    auto &set = res->add_subcommand("set", "set a value");
+    set.add_argument<std::string>("key");
+    set.add_argument<int>("value");
+    res->add_subcommand("get", "get a value").add_argument<std::string>("key");
+    res->freeze();
+    return res;
+  }();
+  return *parser;
+}
+
+template <typename Output>
+static void BM_ParseThroughput(benchmark::State &state) {
+  const argparse::ArgumentParser &parser = control_parser();
+  const std::vector<std::string_view> commands[] = {
+      {"-p", "3", "set", "timeout", "30"},
+      {"--verbose", "get", "timeout"},
+      {"set", "retries", "5"}};
+
+  Output output;
+  std::size_t i = 0;
+  for (auto _ : state) {
+    parser.parse(commands[i++ % std::size(commands)], output);
+    benchmark::DoNotOptimize(output);
+  }
+  state.counters["parses_per_core"] =
+      benchmark::Counter(static_cast<double>(state.iterations()),
+                         benchmark::Counter::kAvgThreadsRate);
+}
+BENCHMARK_TEMPLATE(BM_ParseThroughput, argparse::TypedResult)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ParseThroughput, argparse::Result)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+static void BM_ParseManyPositionals(benchmark::State &state) {
+  std::vector<std::string> paths;
+  std::vector<const char *> argv = {"bench"};
+  for (std::int64_t i = 0; i < state.range(0); ++i)
+    paths.push_back("/data/input/" + std::to_string(i) + ".bin");
+  for (const auto &path : paths)
+    argv.push_back(path.c_str());
+
+  std::size_t bytes = 0;
+  argparse::ArgumentParser parser("bench");
+  auto &inputs = parser.add_argument<std::vector<std::string>>("inputs");
+  if (state.range(1) != 0)
+    inputs.sink([&bytes](std::string path) { bytes += path.size(); });
+  parser.freeze();
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        parser.parse_typed(static_cast<int>(argv.size()), argv.data()));
+    benchmark::DoNotOptimize(bytes);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ParseManyPositionals)
+    ->ArgNames({"n", "sink"})
+    ->Args({1 << 10, 0})
+    ->Args({1 << 10, 1})
+    ->Args({1 << 20, 0})
+    ->Args({1 << 20, 1});
+
+static void BM_ParseLargeList(benchmark::State &state) {
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> dist(-1e6, 1e6);
+  std::vector<std::string> tokens;
+  std::vector<const char *> argv = {"bench", "--values"};
+  for (std::int64_t i = 0; i < state.range(0); ++i)
+    tokens.push_back(std::to_string(dist(gen)));
+  for (const auto &token : tokens)
+    argv.push_back(token.c_str());
+
+  argparse::ArgumentParser parser("bench");
+  auto &values = parser.add_argument<std::vector<double>>("--values");
+  if (state.range(1) != 1)
+    values.parallel(static_cast<std::size_t>(state.range(1)));
+  parser.freeze();
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(
+        parser.parse_typed(static_cast<int>(argv.size()), argv.data()));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ParseLargeList)
+    ->ArgNames({"n", "threads"})
+    ->ArgsProduct({{1 << 20}, {1, 2, 4, 8}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_RejectMalformed(benchmark::State &state) {
+  const argparse::ArgumentParser &parser = control_parser();
+  const std::vector<std::string_view> commands[] = {
+      {"-p", "high", "set", "timeout", "30"},
+      {"--verbose", "get"},
+      {"set", "retries", "five"}};
+
+  argparse::TypedResult output;
+  std::size_t i = 0, rejected = 0;
+  for (auto _ : state) {
+    const auto &command = commands[i++ % std::size(commands)];
+    if (state.range(0) != 0) {
+      rejected += static_cast<bool>(parser.try_parse(command, output));
+    } else {
+      try {
+        parser.parse(command, output);
+      } catch (const argparse::ParseException &) {
+        ++rejected;
+      }
+    }
+  }
+  benchmark::DoNotOptimize(rejected);
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RejectMalformed)->ArgName("expected")->Arg(0)->Arg(1);
+
+static void BM_ParseValidated(benchmark::State &state) {
+  argparse::ArgumentParser parser("bench");
+  for (int i = 0; i < 64; ++i)
+    parser.add_argument("--flag-" + std::to_string(i))
+        .group(i % 2 == 0 ? "Even" : "Odd");
+  auto &level    = parser.add_argument<int>("-l", "--level");
+  auto &mode     = parser.add_argument<std::string>("--mode");
+  auto &password = parser.add_argument<std::string>("--password");
+  const bool declarative = state.range(0) != 0;
+  if (declarative) {
+    level.range(1, 9);
+    mode.choices({"fast", "safe"});
+    password.depends_on("--flag-1");
+    parser.mutually_exclusive("Even").required_group("Odd");
+  }
+  parser.freeze();
+
+  const char *argv[] = {"bench",  "--flag-2", "--flag-1",   "-l", "3",
+                        "--mode", "fast",     "--password", "pw"};
+  for (auto _ : state) {
+    argparse::Result res = parser.parse_args(9, argv);
+    if (!declarative) {
+      std::size_t even = 0, odd = 0;
+      for (int i = 0; i < 64; ++i)
+        (i % 2 == 0 ? even : odd) +=
+            res.get<bool>("flag-" + std::to_string(i)) ? 1 : 0;
+      const int value   = res.get<int>("level");
+      const auto choice = res.get<std::string>("mode");
+      if (even > 1 || odd == 0 || value < 1 || value > 9 ||
+          (choice != "fast" && choice != "safe") ||
+          (res.has("password") && !res.get<bool>("flag-1")))
+        state.SkipWithError("validation failed");
+    }
+    benchmark::DoNotOptimize(res);
+  }
+}
+BENCHMARK(BM_ParseValidated)->ArgName("declarative")->Arg(0)->Arg(1);
+
+static void BM_ParseWithFallbacks(benchmark::State &state) {
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "argparse-bench.ini").string();
+  {
+    std::ofstream file(path);
+    for (int section = 0; section < 16; ++section) {
+      file << "[section-" << section << "]\n";
+      for (int i = 0; i < 64; ++i)
+        file << "key-" << i << " = " << section * 64 + i << '\n';
+    }
+  }
+  argparse::ArgumentParser parser("bench");
+  for (int i = 0; i < 64; ++i)
+    parser.add_argument<int>("--option-" + std::to_string(i))
+        .config("section-" + std::to_string(i % 16) + ".key-" +
+                std::to_string(i))
+        .default_value(0);
+  parser.config_file(path);
+  parser.freeze();
+
+  std::vector<std::string> args{"bench"};
+  for (int i = static_cast<int>(state.range(0)); i < 64; ++i) {
+    args.push_back("--option-" + std::to_string(i));
+    args.push_back(std::to_string(i));
+  }
+  std::vector<const char *> argv;
+  for (const auto &arg : args)
+    argv.push_back(arg.c_str());
+  for (auto _ : state) {
+    argparse::Result res =
+        parser.parse_args(static_cast<int>(argv.size()), argv.data());
+    benchmark::DoNotOptimize(res);
+  }
+  std::filesystem::remove(path);
+}
+BENCHMARK(BM_ParseWithFallbacks)
+    ->ArgName("unresolved")
+    ->Arg(0)
+    ->Arg(8)
+    ->Arg(64);
@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+
+#include <argparse/argparse.hpp>
+
+#include <string>
+#include <vector>
+
+namespace {
+struct Fixture {
+  explicit Fixture(std::size_t count) : parser("bench") {
+    argv.push_back("bench");
+    flags.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+      names.push_back("option-" + std::to_string(i));
+      handles.push_back(parser.add_argument<int>("--" + names.back()));
+      values.push_back(std::to_string(i));
+    }
+    for (std::size_t i = 0; i < count; i += 2) {
+      flags.push_back("--" + names[i]);
+      argv.push_back(flags.back().c_str());
+      argv.push_back(values[i].c_str());
+    }
+    parser.freeze();
+  }
+
+  argparse::ArgumentParser parser;
+  std::vector<std::string> names, flags, values;
+  std::vector<argparse::ArgHandle<int>> handles;
+  std::vector<const char *> argv;
+};
+} // namespace
+
+static void BM_ResultGetByName(benchmark::State &state) {
+  Fixture fixture(static_cast<std::size_t>(state.range(0)));
+  const argparse::Result res = fixture.parser.parse_args(
+      static_cast<int>(fixture.argv.size()), fixture.argv.data());
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < fixture.names.size(); i += 2)
+      benchmark::DoNotOptimize(res.get<int>(fixture.names[i]));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) / 2);
+}
+BENCHMARK(BM_ResultGetByName)->RangeMultiplier(10)->Range(10, 1000);
+
+static void BM_ResultHasByName(benchmark::State &state) {
+  Fixture fixture(static_cast<std::size_t>(state.range(0)));
+  const argparse::Result res = fixture.parser.parse_args(
+      static_cast<int>(fixture.argv.size()), fixture.argv.data());
+  for (auto _ : state) {
+    for (const auto &name : fixture.names)
+      benchmark::DoNotOptimize(res.has(name));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ResultHasByName)->RangeMultiplier(10)->Range(10, 1000);
+
+static void BM_ResultGetByHandle(benchmark::State &state) {
+  Fixture fixture(static_cast<std::size_t>(state.range(0)));
+  const argparse::Result res = fixture.parser.parse_args(
+      static_cast<int>(fixture.argv.size()), fixture.argv.data());
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < fixture.handles.size(); i += 2)
+      benchmark::DoNotOptimize(res.get(fixture.handles[i]));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) / 2);
+}
+BENCHMARK(BM_ResultGetByHandle)->RangeMultiplier(10)->Range(10, 1000);
+
+static void BM_TypedResultGetByHandle(benchmark::State &state) {
+  Fixture fixture(static_cast<std::size_t>(state.range(0)));
+  const argparse::TypedResult res = fixture.parser.parse_typed(
+      static_cast<int>(fixture.argv.size()), fixture.argv.data());
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < fixture.handles.size(); i += 2)
+      benchmark::DoNotOptimize(res.get(fixture.handles[i]));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) / 2);
+}
+BENCHMARK(BM_TypedResultGetByHandle)->RangeMultiplier(10)->Range(10, 1000);
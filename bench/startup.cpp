@@ -0,0 +1,43 @@
+#include <benchmark/benchmark.h>
+
+#include <argparse/argparse.hpp>
+
+#include <regex>
+
+static void BM_StartupRegexPatterns(benchmark::State &state) {
+  for (auto _ : state) {
+    std::basic_regex<char> truthy("(t|T)(rue)?|1");
+    std::basic_regex<char> falsy("(f|F)(else)?|0");
+    std::basic_regex<char> integer(
+        "(-)?(0x|0X|0b|0)?([0-9a-zA-Z]+)|((0x|0X|0b)?0)");
+    benchmark::DoNotOptimize(truthy);
+    benchmark::DoNotOptimize(falsy);
+    benchmark::DoNotOptimize(integer);
+  }
+}
+BENCHMARK(BM_StartupRegexPatterns);
+
+static void BM_StartupParser(benchmark::State &state) {
+  const char *argv[] = {"bench", "--verbose", "--jobs", "8", "input"};
+  for (auto _ : state) {
+    argparse::ArgumentParser parser("bench");
+    parser.add_argument("-v", "--verbose");
+    parser.add_argument<int>("-j", "--jobs");
+    parser.add_argument<std::string>("input");
+    benchmark::DoNotOptimize(parser.parse_args(5, argv));
+  }
+}
+BENCHMARK(BM_StartupParser);
+
+static void BM_ParseBool(benchmark::State &state) {
+  const std::string_view corpus[] = {"1", "true", "F", "false", "True", "0"};
+  for (auto _ : state) {
+    for (auto text : corpus) {
+      bool value = false;
+      argparse::parse(text, value);
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * 6);
+}
+BENCHMARK(BM_ParseBool);
@@ -0,0 +1,82 @@
+#include <benchmark/benchmark.h>
+
+#include <argparse/argparse.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+static std::string make_line(std::size_t tokens, bool quoted) {
+  const char *plain[]  = {"--input", "/var/lib/service/data.bin", "-j", "16",
+                          "--name=worker", "verbose"};
+  const char *quotes[] = {"--message", "'hello, world'", "\"a \\\"b\\\" c\"",
+                          "path\\ with\\ spaces", "\"$HOME/dir\"", "plain"};
+  std::string line;
+  for (std::size_t i = 0; i < tokens; ++i) {
+    line += quoted ? quotes[i % 6] : plain[i % 6];
+    line += ' ';
+  }
+  return line;
+}
+
+static void BM_Tokenize(benchmark::State &state, bool quoted) {
+  const std::string line =
+      make_line(static_cast<std::size_t>(state.range(0)), quoted);
+  argparse::Tokenizer tokenizer;
+  for (auto _ : state)
+    benchmark::DoNotOptimize(tokenizer(line).data());
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<std::int64_t>(line.size()));
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK_CAPTURE(BM_Tokenize, plain, false)
+    ->RangeMultiplier(16)
+    ->Range(8, 1 << 16)
+    ->Complexity(benchmark::oN);
+BENCHMARK_CAPTURE(BM_Tokenize, quoted, true)
+    ->RangeMultiplier(16)
+    ->Range(8, 1 << 16)
+    ->Complexity(benchmark::oN);
+
+static void BM_TokenizeAndParse(benchmark::State &state) {
+  argparse::ArgumentParser parser("bench");
+  parser.add_argument<std::string>("-m", "--message");
+  parser.add_argument<int>("-j", "--jobs");
+  parser.add_argument<std::vector<std::string>>("files");
+  parser.freeze();
+
+  const std::string line = "-j 8 -m 'rebuild all' a.txt \"b c.txt\" d\\ e.txt";
+  argparse::Tokenizer tokenizer;
+  argparse::TypedResult values;
+  for (auto _ : state) {
+    parser.parse(tokenizer(line), values);
+    benchmark::DoNotOptimize(values);
+  }
+}
+BENCHMARK(BM_TokenizeAndParse);
+
+static void BM_ResponseFile(benchmark::State &state) {
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "argparse-bench.rsp").string();
+  {
+    std::ofstream file(path);
+    file << "--ids";
+    for (std::int64_t i = 0; i < state.range(0); ++i)
+      file << (i % 16 == 0 ? '\n' : ' ') << i * 7919;
+    file << "\n--output 'out file.bin'\n";
+  }
+
+  argparse::ArgumentParser parser("bench");
+  parser.add_argument<std::vector<std::int64_t>>("--ids");
+  parser.add_argument<std::string>("--output");
+  parser.response_files().freeze();
+
+  const std::string arg = "@" + path;
+  const char *argv[]    = {"bench", arg.c_str()};
+  for (auto _ : state)
+    benchmark::DoNotOptimize(parser.parse_typed(2, argv));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  std::remove(path.c_str());
+}
+BENCHMARK(BM_ResponseFile)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+
+#include <argparse/argparse.hpp>
+
+#include <string>
+
+static std::string make_text(std::size_t words, bool utf8) {
+  const char *ascii[] = {"lorem", "ipsum", "dolor", "sit", "amet,",
+                         "consectetur", "adipiscing", "elit"};
+  const char *wide[]  = {"lörem", "ïpsum", "日本語", "sit", "àmet,",
+                         "\U0001F600", "adipiscing", "élit"};
+  std::string text;
+  for (std::size_t i = 0; i < words; ++i) {
+    text += utf8 ? wide[i % 8] : ascii[i % 8];
+    text += i % 97 == 96 ? '\n' : ' ';
+  }
+  return text;
+}
+
+static void BM_Wrap(benchmark::State &state, bool utf8) {
+  const std::string text =
+      make_text(static_cast<std::size_t>(state.range(0)), utf8);
+  std::string out;
+  for (auto _ : state) {
+    out.clear();
+    argparse::detail::append_wrapped(out, text, 24, 24, 100);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<std::int64_t>(text.size()));
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK_CAPTURE(BM_Wrap, ascii, false)
+    ->RangeMultiplier(16)
+    ->Range(1 << 8, 1 << 20)
+    ->Complexity(benchmark::oN);
+BENCHMARK_CAPTURE(BM_Wrap, utf8, true)
+    ->RangeMultiplier(16)
+    ->Range(1 << 8, 1 << 20)
+    ->Complexity(benchmark::oN);
+
+static void BM_DisplayWidth(benchmark::State &state, bool utf8) {
+  const std::string text = make_text(1 << 12, utf8);
+  for (auto _ : state)
+    benchmark::DoNotOptimize(argparse::detail::display_width(text));
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<std::int64_t>(text.size()));
+}
+BENCHMARK_CAPTURE(BM_DisplayWidth, ascii, false);
+BENCHMARK_CAPTURE(BM_DisplayWidth, utf8, true);
@@ -2,19 +2,37 @@
 
 #include <algorithm>
 #include <any>
+#include <atomic>
+#include <array>
+#include <bitset>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
 #include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <exception>
 #include <functional>
-#include <iostream>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
 #include <optional>
-#include <regex>
+#include <ostream>
 #include <set>
+#include <stdexcept>
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <system_error>
+#include <thread>
 #include <tuple>
 #include <type_traits>
+#include <utility>
 #include <unordered_map>
 #include <vector>
 
@@ -30,6 +48,38 @@
 #  endif
 #endif
 
+#if defined(__cpp_lib_to_chars) && !defined(ARGPARSE_NO_FLOAT_FROM_CHARS)
+#  define ARGPARSE_FLOAT_FROM_CHARS
+#endif
+
+#if (defined(__unix__) || defined(__APPLE__)) &&                               \
+    !defined(ARGPARSE_NO_TERMINAL_WIDTH)
+#  define ARGPARSE_TERMINAL_WIDTH
+#  include <sys/ioctl.h>
+#  include <unistd.h>
+#endif
+
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(ARGPARSE_NO_MMAP)
+#  define ARGPARSE_MMAP
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+#if !defined(ARGPARSE_NO_THREADS)
+#  define ARGPARSE_THREADS
+#endif
+
+#if defined(ARGPARSE_INSTRUMENTATION)
+#  include <chrono>
+#endif
+
+#if defined(__SSE2__) && !defined(ARGPARSE_NO_SIMD)
+#  define ARGPARSE_SIMD_SSE2
+#  include <emmintrin.h>
+#endif
+
 #define ARGPARSE_VERSION_MAJOR 0
 #define ARGPARSE_VERSION_MINOR 1
 #define ARGPARSE_VERSION_PATCH 0
@@ -37,10 +87,15 @@
 namespace argparse {
 
 namespace detail {
-static const std::basic_regex<char> truthy_pattern("(t|T)(rue)?|1");
-static const std::basic_regex<char> falsy_pattern("(f|F)(else)?|0");
-static const std::basic_regex<char>
-    integer_pattern("(-)?(0x|0X|0b|0)?([0-9a-zA-Z]+)|((0x|0X|0b)?0)");
+constexpr bool is_truthy(std::string_view text) noexcept {
+  return text == "1" || text == "t" || text == "T" || text == "true" ||
+         text == "True";
+}
+
+constexpr bool is_falsy(std::string_view text) noexcept {
+  return text == "0" || text == "f" || text == "F" || text == "false" ||
+         text == "False";
+}
 
 #if defined(_MSC_VER) && !defined(__clang__)
 template <typename T> struct identity { using type = T; };
@@ -85,6 +140,32 @@ public:
   static const bool value = result::value;
 };
 
+template <typename T> struct is_vector : std::false_type {};
+template <typename T> struct is_vector<std::vector<T>> : std::true_type {};
+
+template <typename T, typename = void>
+struct is_equality_comparable : std::false_type {};
+template <typename T>
+struct is_equality_comparable<
+    T, std::void_t<decltype(std::declval<const T &>() ==
+                            std::declval<const T &>())>> : std::true_type {};
+
+inline unsigned countr_zero(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned>(__builtin_ctzll(word));
+#else
+  unsigned res = 0;
+  for (; (word & 1) == 0; word >>= 1)
+    ++res;
+  return res;
+#endif
+}
+
+inline constexpr std::size_t parallel_grain = 1 << 12;
+
+template <typename T> struct element_type { using type = T; };
+template <typename T> struct element_type<std::vector<T>> { using type = T; };
+
 template <typename T, typename _ = void>
 struct is_container : std::false_type {};
 
@@ -104,40 +185,297 @@ struct is_container<
                                decltype(std::declval<T>().cend())>,
            void>> : public std::true_type {};
 
-inline std::string wrap(std::string_view text, std::uint8_t indent = 0,
-                        std::uint8_t init_width = 0, std::uint8_t width = 80) {
-  std::size_t line_length = init_width;
-  std::string result;
+struct CodepointRange {
+  char32_t first, last;
+};
+
+inline constexpr CodepointRange zero_width_ranges[] = {
+    {0x0300, 0x036F},   {0x0483, 0x0489},   {0x0591, 0x05BD},
+    {0x05BF, 0x05BF},   {0x05C1, 0x05C2},   {0x05C4, 0x05C5},
+    {0x05C7, 0x05C7},   {0x0610, 0x061A},   {0x064B, 0x065F},
+    {0x0670, 0x0670},   {0x06D6, 0x06DC},   {0x06DF, 0x06E4},
+    {0x06E7, 0x06E8},   {0x06EA, 0x06ED},   {0x0711, 0x0711},
+    {0x0730, 0x074A},   {0x07A6, 0x07B0},   {0x07EB, 0x07F3},
+    {0x0901, 0x0902},   {0x093C, 0x093C},   {0x0941, 0x0948},
+    {0x094D, 0x094D},   {0x0951, 0x0954},   {0x0962, 0x0963},
+    {0x0E31, 0x0E31},   {0x0E34, 0x0E3A},   {0x0E47, 0x0E4E},
+    {0x1160, 0x11FF},   {0x1AB0, 0x1AFF},   {0x1DC0, 0x1DFF},
+    {0x200B, 0x200F},   {0x202A, 0x202E},   {0x2060, 0x2064},
+    {0x20D0, 0x20FF},   {0x302A, 0x302F},   {0x3099, 0x309A},
+    {0xFE00, 0xFE0F},   {0xFE20, 0xFE2F},   {0xFEFF, 0xFEFF},
+    {0x1F3FB, 0x1F3FF}, {0xE0000, 0xE0FFF}};
+
+inline constexpr CodepointRange wide_ranges[] = {
+    {0x1100, 0x115F},   {0x231A, 0x231B},   {0x2329, 0x232A},
+    {0x23E9, 0x23EC},   {0x23F0, 0x23F0},   {0x23F3, 0x23F3},
+    {0x25FD, 0x25FE},   {0x2614, 0x2615},   {0x2648, 0x2653},
+    {0x267F, 0x267F},   {0x2693, 0x2693},   {0x26A1, 0x26A1},
+    {0x26AA, 0x26AB},   {0x26BD, 0x26BE},   {0x26C4, 0x26C5},
+    {0x26CE, 0x26CE},   {0x26D4, 0x26D4},   {0x26EA, 0x26EA},
+    {0x26F2, 0x26F3},   {0x26F5, 0x26F5},   {0x26FA, 0x26FA},
+    {0x26FD, 0x26FD},   {0x2705, 0x2705},   {0x270A, 0x270B},
+    {0x2728, 0x2728},   {0x274C, 0x274C},   {0x274E, 0x274E},
+    {0x2753, 0x2755},   {0x2757, 0x2757},   {0x2795, 0x2797},
+    {0x27B0, 0x27B0},   {0x27BF, 0x27BF},   {0x2B1B, 0x2B1C},
+    {0x2B50, 0x2B50},   {0x2B55, 0x2B55},   {0x2E80, 0x303E},
+    {0x3041, 0x33FF},   {0x3400, 0x4DBF},   {0x4E00, 0x9FFF},
+    {0xA000, 0xA4CF},   {0xA960, 0xA97F},   {0xAC00, 0xD7A3},
+    {0xF900, 0xFAFF},   {0xFE10, 0xFE19},   {0xFE30, 0xFE6F},
+    {0xFF00, 0xFF60},   {0xFFE0, 0xFFE6},   {0x16FE0, 0x16FE4},
+    {0x17000, 0x18CFF}, {0x1B000, 0x1B2FF}, {0x1F004, 0x1F004},
+    {0x1F0CF, 0x1F0CF}, {0x1F18E, 0x1F18E}, {0x1F191, 0x1F19A},
+    {0x1F200, 0x1F251}, {0x1F300, 0x1F64F}, {0x1F680, 0x1F6FF},
+    {0x1F900, 0x1F9FF}, {0x1FA70, 0x1FAFF}, {0x20000, 0x2FFFD},
+    {0x30000, 0x3FFFD}};
+
+template <std::size_t N>
+constexpr bool in_ranges(const CodepointRange (&ranges)[N],
+                         char32_t cp) noexcept {
+  std::size_t lo = 0, hi = N;
+  while (lo < hi) {
+    const std::size_t mid = lo + (hi - lo) / 2;
+    if (ranges[mid].last < cp)
+      lo = mid + 1;
+    else if (ranges[mid].first > cp)
+      hi = mid;
+    else
+      return true;
+  }
+  return false;
+}
 
-  std::string prefix = "\n" + std::string(indent, ' ');
+constexpr std::size_t codepoint_width(char32_t cp) noexcept {
+  if (cp < 0x20 || (cp >= 0x7F && cp < 0xA0))
+    return 0;
+  if (cp < 0x300)
+    return 1;
+  if (in_ranges(zero_width_ranges, cp))
+    return 0;
+  return in_ranges(wide_ranges, cp) ? 2 : 1;
+}
+
+constexpr char32_t decode_utf8(std::string_view text,
+                               std::size_t &pos) noexcept {
+  const auto lead = static_cast<unsigned char>(text[pos++]);
+  std::size_t count = 0;
+  char32_t cp       = lead;
+  if (lead >= 0xF0 && lead < 0xF8) {
+    count = 3;
+    cp    = lead & 0x07u;
+  } else if (lead >= 0xE0) {
+    count = 2;
+    cp    = lead & 0x0Fu;
+  } else if (lead >= 0xC0) {
+    count = 1;
+    cp    = lead & 0x1Fu;
+  } else if (lead >= 0x80) {
+    return 0xFFFD;
+  }
+  if (lead >= 0xF8 || pos + count > text.size())
+    return 0xFFFD;
+  for (std::size_t i = 0; i < count; ++i) {
+    const auto next = static_cast<unsigned char>(text[pos + i]);
+    if ((next & 0xC0u) != 0x80u)
+      return 0xFFFD;
+    cp = (cp << 6) | (next & 0x3Fu);
+  }
+  pos += count;
+  return cp;
+}
+
+inline void encode_utf8(std::string &out, char32_t cp) {
+  if (cp < 0x80) {
+    out += static_cast<char>(cp);
+  } else if (cp < 0x800) {
+    out += static_cast<char>(0xC0u | (cp >> 6));
+    out += static_cast<char>(0x80u | (cp & 0x3Fu));
+  } else if (cp < 0x10000) {
+    out += static_cast<char>(0xE0u | (cp >> 12));
+    out += static_cast<char>(0x80u | ((cp >> 6) & 0x3Fu));
+    out += static_cast<char>(0x80u | (cp & 0x3Fu));
+  } else {
+    out += static_cast<char>(0xF0u | (cp >> 18));
+    out += static_cast<char>(0x80u | ((cp >> 12) & 0x3Fu));
+    out += static_cast<char>(0x80u | ((cp >> 6) & 0x3Fu));
+    out += static_cast<char>(0x80u | (cp & 0x3Fu));
+  }
+}
+
+constexpr std::size_t display_width(std::string_view text) noexcept {
+  std::size_t width = 0, pos = 0;
+  char32_t prev     = 0;
+  while (pos < text.size()) {
+    if (static_cast<unsigned char>(text[pos]) < 0x80) {
+      width += codepoint_width(static_cast<unsigned char>(text[pos++]));
+      prev = 0;
+      continue;
+    }
+    const char32_t cp = decode_utf8(text, pos);
+    if (prev != 0x200D)
+      width += codepoint_width(cp);
+    prev = cp;
+  }
+  return width;
+}
+
+inline std::size_t terminal_width() {
+  if (const char *columns = std::getenv("COLUMNS")) {
+    const char *last      = columns + std::strlen(columns);
+    std::size_t value     = 0;
+    const auto [ptr, err] = std::from_chars(columns, last, value);
+    if (err == std::errc{} && ptr == last && value > 0)
+      return value;
+  }
+#ifdef ARGPARSE_TERMINAL_WIDTH
+  winsize size{};
+  if (::ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col > 0)
+    return size.ws_col;
+  if (::ioctl(STDERR_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col > 0)
+    return size.ws_col;
+#endif
+  return 80;
+}
+
+inline std::string &append_wrapped(std::string &out, std::string_view text,
+                                   std::size_t indent     = 0,
+                                   std::size_t init_width = 0,
+                                   std::size_t width      = 80) {
+  std::size_t column = init_width;
+  bool fresh         = true;
+  const auto newline = [&]() {
+    out += '\n';
+    out.append(indent, ' ');
+    column = indent;
+    fresh  = true;
+  };
+
+  std::size_t pos = 0;
+  while (pos < text.size()) {
+    if (text[pos] == '\n') {
+      newline();
+      ++pos;
+      continue;
+    }
 
-  std::size_t prev = 0, pos = 0;
-  while ((pos = text.find(' ', prev + 1)) != std::string_view::npos) {
-    if (line_length + (pos - prev) > width) {
-      result += prefix;
-      result += std::string{text.substr(prev + 1, (pos - prev) - 1)};
-      line_length = (pos - prev) - 1 + prefix.length() - 1;
+    const std::size_t sep = pos;
+    while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t'))
+      ++pos;
+    const std::size_t begin = pos;
+    while (pos < text.size() && text[pos] != ' ' && text[pos] != '\t' &&
+           text[pos] != '\n')
+      ++pos;
+    if (begin == pos)
+      continue;
+
+    const std::string_view word  = text.substr(begin, pos - begin);
+    const std::size_t sep_width  = begin - sep;
+    const std::size_t word_width = display_width(word);
+    if (column + sep_width + word_width <= width) {
+      out += text.substr(sep, pos - sep);
+      column += sep_width + word_width;
+      fresh = false;
+    } else if (indent + word_width <= width) {
+      if (!fresh || column > indent)
+        newline();
+      out += word;
+      column += word_width;
+      fresh = false;
     } else {
-      result += std::string{text.substr(prev, pos - prev)};
-      line_length += (pos - prev);
+      if (!fresh)
+        newline();
+      std::size_t offset = 0;
+      char32_t prev      = 0;
+      while (offset < word.size()) {
+        const std::size_t first    = offset;
+        const char32_t cp          = decode_utf8(word, offset);
+        const std::size_t cp_width = prev == 0x200D ? 0 : codepoint_width(cp);
+        prev                       = cp;
+        if (column + cp_width > width && (!fresh || column > indent))
+          newline();
+        out += word.substr(first, offset - first);
+        column += cp_width;
+        fresh = false;
+      }
     }
-    prev = pos;
   }
+  return out;
+}
 
-  if (line_length + (text.length() - prev) > width) {
-    result += prefix;
-    result += std::string{text.substr(prev + 1, (text.length() - prev) - 1)};
-  } else {
-    result += std::string{text.substr(prev, text.length() - prev)};
+inline std::string wrap(std::string_view text, std::size_t indent = 0,
+                        std::size_t init_width = 0, std::size_t width = 80) {
+  std::string result;
+  result.reserve(text.size() + text.size() / (width + 1) * (indent + 1));
+  append_wrapped(result, text, indent, init_width, width);
+  return result;
+}
+
+template <typename T>
+inline bool from_chars(const char *first, const char *last, T &value,
+                       bool hex) {
+#ifdef ARGPARSE_FLOAT_FROM_CHARS
+  const auto [ptr, err] =
+      std::from_chars(first, last, value,
+                      hex ? std::chars_format::hex : std::chars_format::general);
+  return ptr == last && err == std::errc{};
+#else
+  const std::string buffer =
+      hex ? "0x" + std::string(first, last) : std::string(first, last);
+  char *end = nullptr;
+  errno     = 0;
+  if constexpr (std::is_same<T, float>::value)
+    value = std::strtof(buffer.c_str(), &end);
+  else if constexpr (std::is_same<T, double>::value)
+    value = std::strtod(buffer.c_str(), &end);
+  else
+    value = std::strtold(buffer.c_str(), &end);
+  return end == buffer.c_str() + buffer.size() && errno != ERANGE;
+#endif
+}
+
+inline std::size_t count_delimiters(std::string_view text,
+                                    std::string_view delimiters) {
+  if (delimiters.size() == 1)
+    return static_cast<std::size_t>(
+        std::count(text.begin(), text.end(), delimiters[0]));
+  return static_cast<std::size_t>(
+      std::count_if(text.begin(), text.end(), [delimiters](char c) {
+        return delimiters.find(c) != std::string_view::npos;
+      }));
+}
+
+template <typename Callback>
+inline void split(std::string_view text, std::string_view delimiters,
+                  Callback &&callback) {
+  std::size_t prev = 0;
+  while (prev < text.size()) {
+    std::size_t pos = delimiters.size() == 1
+                          ? text.find(delimiters[0], prev)
+                          : text.find_first_of(delimiters, prev);
+    if (pos == std::string_view::npos)
+      pos = text.size();
+    callback(text.substr(prev, pos - prev));
+    prev = pos + 1;
   }
+}
+
+inline void append_padded(std::string &out, std::string_view text,
+                          std::size_t width) {
+  out += text;
+  const std::size_t length = display_width(text);
+  if (length < width)
+    out.append(width - length, ' ');
+}
 
+inline std::string pad_right(std::string_view text, std::size_t width) {
+  std::string result;
+  result.reserve(std::max(text.length(), width));
+  append_padded(result, text, width);
   return result;
 }
 
-inline std::string pad_right(std::string_view text, std::uint8_t width) {
-  if (text.length() >= width)
-    return std::string{text};
-  return std::string{text} + std::string(width - text.length(), ' ');
+inline bool is_negative_number(std::string_view text) {
+  return text.size() > 1 && text[0] == '-' &&
+         (std::isdigit(static_cast<unsigned char>(text[1])) || text[1] == '.');
 }
 
 inline bool is_positional(std::string_view name) {
@@ -149,6 +487,44 @@ inline bool is_positional(std::string_view name) {
     return true;
 }
 
+constexpr bool is_shell_space(char c) noexcept {
+  return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+inline const char *find_shell_special(const char *first, const char *last,
+                                      bool quoted) noexcept {
+#ifdef ARGPARSE_SIMD_SSE2
+  const __m128i dquote    = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i squote    = _mm_set1_epi8('\'');
+  const __m128i space     = _mm_set1_epi8(' ');
+  const __m128i tab       = _mm_set1_epi8('\t');
+  const __m128i controls  = _mm_set1_epi8('\r' - '\t');
+  for (; last - first >= 16; first += 16) {
+    const __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+    __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, dquote),
+                                _mm_cmpeq_epi8(chunk, backslash));
+    if (!quoted) {
+      const __m128i offset = _mm_sub_epi8(chunk, tab);
+      hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, squote));
+      hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, space));
+      hits = _mm_or_si128(
+          hits, _mm_cmpeq_epi8(_mm_min_epu8(offset, controls), offset));
+    }
+    const int mask = _mm_movemask_epi8(hits);
+    if (mask != 0)
+      return first + __builtin_ctz(static_cast<unsigned>(mask));
+  }
+#endif
+  for (; first != last; ++first) {
+    if (*first == '"' || *first == '\\' ||
+        (!quoted && (*first == '\'' || is_shell_space(*first))))
+      return first;
+  }
+  return last;
+}
+
 #ifdef ARGPARSE_USE_FMT
 template <typename T> std::string to_string(const T &val) {
   return fmt::format(FMT_COMPILE("{}"), val);
@@ -173,6 +549,206 @@ to_string(const T &) {
   return std::string();
 }
 #endif
+
+class NameTrie {
+public:
+  static constexpr std::uint32_t npos =
+      std::numeric_limits<std::uint32_t>::max();
+
+  struct Match {
+    std::uint32_t value;
+    bool ambiguous;
+  };
+
+  NameTrie() : nodes_{} {}
+
+  void build(std::vector<std::pair<std::string_view, std::uint32_t>> entries) {
+    std::sort(entries.begin(), entries.end());
+    nodes_.clear();
+    nodes_.reserve(entries.size() * 4 + 1);
+    nodes_.push_back({0, 0, npos, npos, '\0'});
+    if (!entries.empty())
+      build(0, entries, 0, entries.size(), 0);
+  }
+
+  Match find(std::string_view name, bool prefix) const {
+    if (nodes_.empty())
+      return {npos, false};
+    std::size_t node = 0;
+    for (char c : name) {
+      const Node *first = nodes_.data() + nodes_[node].first;
+      const Node *last  = first + nodes_[node].count;
+      const Node *it =
+          std::lower_bound(first, last, c, [](const Node &lhs, char rhs) {
+            return static_cast<unsigned char>(lhs.label) <
+                   static_cast<unsigned char>(rhs);
+          });
+      if (it == last || it->label != c)
+        return {npos, false};
+      node = static_cast<std::size_t>(it - nodes_.data());
+    }
+    if (nodes_[node].value != npos || !prefix)
+      return {nodes_[node].value, false};
+    return {nodes_[node].unique, nodes_[node].unique == npos};
+  }
+
+private:
+  struct Node {
+    std::uint32_t first, count, value, unique;
+    char label;
+  };
+
+  void build(
+      std::size_t node,
+      const std::vector<std::pair<std::string_view, std::uint32_t>> &entries,
+      std::size_t lo, std::size_t hi, std::size_t depth) {
+    nodes_[node].unique = entries[lo].second;
+    for (std::size_t i = lo + 1; i < hi; ++i)
+      if (entries[i].second != entries[lo].second)
+        nodes_[node].unique = npos;
+
+    if (entries[lo].first.size() == depth)
+      nodes_[node].value = entries[lo++].second;
+
+    std::uint32_t count = 0;
+    for (std::size_t i = lo; i < hi; ++i)
+      if (i == lo || entries[i].first[depth] != entries[i - 1].first[depth])
+        ++count;
+
+    const std::size_t first = nodes_.size();
+    nodes_[node].first      = static_cast<std::uint32_t>(first);
+    nodes_[node].count      = count;
+    nodes_.resize(first + count);
+
+    for (std::size_t child = first; lo < hi; ++child) {
+      std::size_t end = lo + 1;
+      while (end < hi && entries[end].first[depth] == entries[lo].first[depth])
+        ++end;
+      nodes_[child] = {0, 0, npos, npos, entries[lo].first[depth]};
+      build(child, entries, lo, end, depth + 1);
+      lo = end;
+    }
+  }
+
+  std::vector<Node> nodes_;
+};
+
+template <typename T> struct ResourceDelete {
+  std::pmr::memory_resource *resource;
+
+  void operator()(T *ptr) const {
+    ptr->~T();
+    resource->deallocate(ptr, sizeof(T), alignof(T));
+  }
+};
+
+template <typename T>
+using resource_ptr = std::unique_ptr<T, ResourceDelete<T>>;
+
+template <typename T, typename... Args>
+resource_ptr<T> make_resource_ptr(std::pmr::memory_resource *resource,
+                                  Args &&...args) {
+  void *ptr = resource->allocate(sizeof(T), alignof(T));
+  try {
+    return resource_ptr<T>(new (ptr) T(std::forward<Args>(args)...),
+                           ResourceDelete<T>{resource});
+  } catch (...) {
+    resource->deallocate(ptr, sizeof(T), alignof(T));
+    throw;
+  }
+}
+
+class StringArena {
+public:
+  explicit StringArena(
+      std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+      : resource_(resource), blocks_(resource), used_(0), capacity_(0) {}
+  StringArena(const StringArena &) = delete;
+  StringArena(StringArena &&other) noexcept
+      : resource_(other.resource_), blocks_(std::move(other.blocks_)),
+        used_(other.used_), capacity_(other.capacity_) {
+    other.blocks_.clear();
+    other.used_     = 0;
+    other.capacity_ = 0;
+  }
+  ~StringArena() { release(); }
+
+  StringArena &operator=(const StringArena &) = delete;
+  StringArena &operator=(StringArena &&other) noexcept {
+    if (this != &other) {
+      release();
+      resource_ = other.resource_;
+      blocks_.assign(other.blocks_.begin(), other.blocks_.end());
+      used_     = other.used_;
+      capacity_ = other.capacity_;
+      other.blocks_.clear();
+      other.used_     = 0;
+      other.capacity_ = 0;
+    }
+    return *this;
+  }
+
+  std::string_view store(std::string_view text) {
+    if (text.empty())
+      return {};
+    if (capacity_ - used_ < text.size()) {
+      capacity_ = std::max(text.size(), capacity_ == 0 ? 256 : capacity_ * 2);
+      blocks_.push_back(
+          {static_cast<char *>(resource_->allocate(capacity_, 1)), capacity_});
+      used_ = 0;
+    }
+    char *dst = blocks_.back().data + used_;
+    std::memcpy(dst, text.data(), text.size());
+    used_ += text.size();
+    return {dst, text.size()};
+  }
+
+private:
+  struct Block {
+    char *data;
+    std::size_t size;
+  };
+
+  void release() noexcept {
+    for (const Block &block : blocks_)
+      resource_->deallocate(block.data, block.size, 1);
+    blocks_.clear();
+  }
+
+  std::pmr::memory_resource *resource_;
+  std::pmr::vector<Block> blocks_;
+  std::size_t used_, capacity_;
+};
+
+struct Layout {
+  struct Slot {
+    std::size_t offset;
+    void (*destroy)(void *);
+    void (*copy)(void *, const void *);
+    std::any (*release)(void *);
+  };
+
+  explicit Layout(std::string program_name)
+      : name(std::move(program_name)), slots{}, size(0) {}
+
+  template <typename T> std::size_t add() {
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+                  "Over-aligned argument types are not supported.");
+    const std::size_t offset = (size + alignof(T) - 1) / alignof(T) * alignof(T);
+    slots.push_back(
+        {offset, [](void *ptr) { static_cast<T *>(ptr)->~T(); },
+         [](void *dst, const void *src) {
+           new (dst) T(*static_cast<const T *>(src));
+         },
+         [](void *ptr) { return std::any{std::move(*static_cast<T *>(ptr))}; }});
+    size = offset + sizeof(T);
+    return offset;
+  }
+
+  std::string name;
+  std::vector<Slot> slots;
+  std::size_t size;
+};
 } // namespace detail
 
 class Exception : public std::exception {
@@ -207,149 +783,1464 @@ public:
                        std::string{type} + "'") {}
 };
 
-class Value {
-public:
-  template <typename T>
-  Value(const T &value, std::uint8_t count = 0)
-      : value_{std::move(value)}, count_{std::move(count)} {}
+template <typename T,
+          typename std::enable_if<std::is_integral<T>::value>::type * = nullptr>
+inline bool try_parse(std::string_view text, T &value) {
 
-  template <typename T> inline T as() const { return std::any_cast<T>(value_); }
-  inline std::uint8_t count() const { return count_; }
-  inline const std::any get() const { return value_; }
+  using US = typename std::make_unsigned<T>::type;
 
-  inline operator bool() const {
-    if (!value_.has_value())
-      return false;
-    else if (value_.type() == typeid(bool))
-      return std::any_cast<bool>(value_);
-    return true;
-  }
+  const char *first = text.data();
+  const char *last  = text.data() + text.size();
 
-  template <typename T>
-  inline auto operator==(const T &rhs) const -> decltype(rhs == rhs) {
-    return std::any_cast<T>(value_) == rhs;
-  }
-  template <typename T>
-  inline auto operator!=(const T &rhs) const -> decltype(rhs != rhs) {
-    return std::any_cast<T>(value_) != rhs;
-  }
-  template <typename T>
-  inline auto operator<(const T &rhs) const -> decltype(rhs < rhs) {
-    return std::any_cast<T>(value_) < rhs;
-  }
-  template <typename T>
-  inline auto operator>(const T &rhs) const -> decltype(rhs > rhs) {
-    return std::any_cast<T>(value_) > rhs;
-  }
-  template <typename T>
-  inline auto operator<=(const T &rhs) const -> decltype(rhs <= rhs) {
-    return std::any_cast<T>(value_) <= rhs;
-  }
-  template <typename T>
-  inline auto operator>=(const T &rhs) const -> decltype(rhs >= rhs) {
-    return std::any_cast<T>(value_) >= rhs;
+  const bool negative = first != last && *first == '-';
+  if (negative)
+    ++first;
+
+  int base = 10;
+  if (last - first > 1 && first[0] == '0') {
+    if (first[1] == 'x' || first[1] == 'X') {
+      base = 16;
+      first += 2;
+    } else if (first[1] == 'b') {
+      base = 2;
+      first += 2;
+    } else {
+      base = 8;
+      first += 1;
+    }
   }
 
-protected:
-  std::any value_;
-  std::uint8_t count_;
-};
+  US result             = 0;
+  const auto [ptr, err] = std::from_chars(first, last, result, base);
+  if (first == last || ptr != last || err != std::errc{})
+    return false;
 
-class Result {
-public:
-  template <typename T> inline T get(std::string_view key) const {
-    return data_.at(key).as<T>();
-  }
-  inline const Value &operator[](std::string_view key) const {
-    return data_.at(key);
-  }
-  inline std::uint8_t count(std::string_view key) const {
-    return data_.at(key).count();
-  }
-  inline bool has(std::string_view key) const {
-    return data_.find(key) != data_.end();
+  if constexpr (std::numeric_limits<T>::is_signed) {
+    if (negative) {
+      if (result > static_cast<US>(std::numeric_limits<T>::min()))
+        return false;
+    } else {
+      if (result > static_cast<US>(std::numeric_limits<T>::max()))
+        return false;
+    }
   }
 
-  inline void insert(std::string_view key, Value value) {
-    data_.insert({key, std::move(value)});
+  if (negative) {
+    if constexpr (std::numeric_limits<T>::is_signed) {
+      value = static_cast<T>(-static_cast<T>(result - 1) - 1);
+    } else {
+      return false;
+    }
+  } else {
+    value = static_cast<T>(result);
   }
+  return true;
+}
 
-  template <typename T>
-  inline void insert(std::string_view key, const T &value) {
-    data_.insert({key, Value{std::move(value)}});
-  }
+inline bool try_parse(std::string_view text, bool &value) {
+  if (detail::is_truthy(text))
+    value = true;
+  else if (detail::is_falsy(text))
+    value = false;
+  else
+    return false;
+  return true;
+}
 
-private:
-  std::unordered_map<std::string_view, Value> data_;
-};
+inline bool try_parse(std::string_view text, std::string &value) {
+  value.assign(text);
+  return true;
+}
 
-class ArgumentParser;
+inline bool try_parse(std::string_view text, char &c) {
+  if (text.length() != 1)
+    return false;
+  c = text[0];
+  return true;
+}
 
-class ArgumentBase {
-public:
-  virtual ~ArgumentBase() = default;
+template <typename T, typename std::enable_if<
+                          std::is_floating_point<T>::value>::type * = nullptr>
+inline bool try_parse(std::string_view text, T &value) {
+  const char *first = text.data();
+  const char *last  = text.data() + text.size();
 
-  virtual std::string get_usage() const {
-    std::string res;
-    std::string meta =
-        names_.back().substr(names_.back().find_first_not_of('-'));
-    std::transform(meta.begin(), meta.end(), meta.begin(),
-                   [](unsigned char c) { return std::toupper(c); });
-    if (!is_positional_) {
-      res = names_.back();
-    }
+  const bool negative = first != last && *first == '-';
+  if (first != last && (*first == '-' || *first == '+'))
+    ++first;
 
-    if (nargs_ > 0) {
-      for (std::uint8_t i = 0; i < nargs_; ++i)
-        res += " " + meta;
-    } else if (nargs_ == -1) {
-      res += " [" + meta + "]";
-    } else if (nargs_ == -2) {
-      res += " " + meta + " [" + meta + " ...]";
-    } else if (nargs_ == -3) {
-      res += " [" + meta + " [" + meta + " ...]]";
-    }
+  const bool hex = last - first > 2 && first[0] == '0' &&
+                   (first[1] == 'x' || first[1] == 'X');
+  if (hex)
+    first += 2;
 
-    if (!is_required_)
-      res = "[" + res + "]";
-    if (res[0] == ' ')
-      res.erase(res.begin());
-    return res;
-  }
+  T result{};
+  if (first == last || *first == '-' || *first == '+' ||
+      std::isspace(static_cast<unsigned char>(*first)) ||
+      !detail::from_chars(first, last, result, hex))
+    return false;
+  value = negative ? -result : result;
+  return true;
+}
 
-  virtual std::string get_help_key() const {
-    if (description_.empty())
-      return "";
-    std::string res;
-    if (!is_positional_) {
-      for (std::size_t i = 0; i < names_.size(); ++i) {
-        res += names_[i];
-        if (i != names_.size() - 1)
-          res += ", ";
+template <typename T,
+          typename std::enable_if<!std::is_integral<T>::value &&
+                                  !std::is_floating_point<T>::value>::type * =
+              nullptr>
+inline bool try_parse(std::string_view text, T &value) {
+  std::stringstream in(std::string{text});
+  in >> value;
+  return static_cast<bool>(in);
+}
+
+namespace detail {
+template <typename T>
+inline bool try_parse_list(std::string_view text, std::vector<T> &value,
+                           std::string_view delimiters,
+                           std::string_view &failed) {
+  if (text.empty())
+    return true;
+
+  const std::size_t size =
+      value.size() + detail::count_delimiters(text, delimiters) + 1;
+  if (size > value.capacity())
+    value.reserve(std::max(size, value.capacity() * 2));
+
+  std::size_t prev = 0;
+  while (prev < text.size()) {
+    std::size_t pos = delimiters.size() == 1
+                          ? text.find(delimiters[0], prev)
+                          : text.find_first_of(delimiters, prev);
+    if (pos == std::string_view::npos)
+      pos = text.size();
+
+    const std::string_view piece = text.substr(prev, pos - prev);
+    if constexpr (std::is_same<T, bool>::value) {
+      bool v = false;
+      if (!try_parse(piece, v)) {
+        failed = piece;
+        return false;
+      }
+      value.push_back(v);
+    } else {
+      value.emplace_back();
+      if (!try_parse(piece, value.back())) {
+        value.pop_back();
+        failed = piece;
+        return false;
       }
     }
-    if (nargs_ != 0) {
-      std::string meta =
-          names_.back().substr(names_.back().find_first_not_of('-'));
-      std::transform(meta.begin(), meta.end(), meta.begin(),
-                     [](unsigned char c) { return std::toupper(c); });
-      res += " " + meta;
-    }
-    return res;
+    prev = pos + 1;
   }
+  return true;
+}
+
+template <typename T, typename Callback>
+inline bool try_parse_each(std::string_view text, std::string_view delimiters,
+                           Callback &&callback, std::string_view &failed) {
+  bool res = true;
+  detail::split(text, delimiters, [&](std::string_view piece) {
+    if (!res)
+      return;
+    T item{};
+    if (!try_parse(piece, item)) {
+      failed = piece;
+      res    = false;
+      return;
+    }
+    callback(std::move(item));
+  });
+  return res;
+}
+
+template <typename T>
+inline bool try_parse_parallel(const std::string_view *tokens,
+                               std::size_t count, std::vector<T> &value,
+                               std::string_view delimiters,
+                               std::size_t threads, std::string_view &failed) {
+  static_assert(!std::is_same<T, bool>::value,
+                "std::vector<bool> cannot be written concurrently");
+  std::size_t total = 0;
+  bool needs_split  = false;
+  for (std::size_t i = 0; i < count; ++i) {
+    if (tokens[i].empty()) {
+      needs_split = true;
+      continue;
+    }
+    const std::size_t delimiters_found =
+        detail::count_delimiters(tokens[i], delimiters);
+    needs_split = needs_split || delimiters_found != 0;
+    total += delimiters_found + 1;
+  }
+
+  std::vector<std::string_view> pieces;
+  if (needs_split) {
+    pieces.reserve(total);
+    for (std::size_t i = 0; i < count; ++i)
+      detail::split(tokens[i], delimiters, [&pieces](std::string_view item) {
+        pieces.push_back(item);
+      });
+    total = pieces.size();
+  }
+  const std::string_view *items = needs_split ? pieces.data() : tokens;
+
+  const std::size_t base = value.size();
+  value.resize(base + total);
+
+#ifdef ARGPARSE_THREADS
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+#endif
+  threads = std::max<std::size_t>(
+      1, std::min(threads, total / detail::parallel_grain));
+  const std::size_t chunk = (total + threads - 1) / threads;
+
+  std::atomic<std::size_t> first(total);
+  auto work = [&](std::size_t thread) {
+    const std::size_t last = std::min(total, (thread + 1) * chunk);
+    for (std::size_t i = thread * chunk; i < last; ++i) {
+      if (i > first.load(std::memory_order_relaxed))
+        return;
+      if (!try_parse(items[i], value[base + i])) {
+        std::size_t current = first.load(std::memory_order_relaxed);
+        while (i < current && !first.compare_exchange_weak(current, i))
+          ;
+        return;
+      }
+    }
+  };
+
+#ifdef ARGPARSE_THREADS
+  std::vector<std::thread> workers;
+  workers.reserve(threads - 1);
+  for (std::size_t thread = 1; thread < threads; ++thread) {
+    try {
+      workers.emplace_back(work, thread);
+    } catch (const std::system_error &) {
+      work(thread);
+    }
+  }
+  work(0);
+  for (auto &worker : workers)
+    worker.join();
+#else
+  for (std::size_t thread = 0; thread < threads; ++thread)
+    work(thread);
+#endif
+
+  if (first.load() != total) {
+    failed = items[first.load()];
+    value.resize(base);
+    return false;
+  }
+  return true;
+}
+} // namespace detail
+
+template <typename T>
+inline bool try_parse(std::string_view text, std::vector<T> &value,
+                      std::string_view delimiters = ",") {
+  std::string_view failed;
+  return detail::try_parse_list(text, value, delimiters, failed);
+}
+
+template <typename T>
+inline bool try_parse(std::string_view text, std::optional<T> &value) {
+  if (!text.empty()) {
+    T result;
+    if (!try_parse(text, result))
+      return false;
+    value = std::move(result);
+  }
+  return true;
+}
+
+template <typename T> inline void parse(std::string_view text, T &value) {
+  if (!try_parse(text, value))
+    throw argument_incorrect_type{std::string{text}, detail::nameof<T>()};
+}
+
+template <typename T>
+inline void parse(std::string_view text, std::vector<T> &value,
+                  std::string_view delimiters = ",") {
+  std::string_view failed;
+  if (!detail::try_parse_list(text, value, delimiters, failed))
+    throw argument_incorrect_type{std::string{failed}, detail::nameof<T>()};
+}
+
+template <typename T>
+inline void parse(std::string_view text, std::optional<T> &value) {
+  if (!try_parse(text, value))
+    throw argument_incorrect_type{std::string{text}, detail::nameof<T>()};
+}
+
+template <typename T, typename Callback>
+inline void parse_each(std::string_view text, std::string_view delimiters,
+                       Callback &&callback) {
+  std::string_view failed;
+  if (!detail::try_parse_each<T>(text, delimiters,
+                                 std::forward<Callback>(callback), failed))
+    throw argument_incorrect_type{std::string{failed}, detail::nameof<T>()};
+}
+
+template <typename T>
+inline void parse_parallel(const std::string_view *tokens, std::size_t count,
+                           std::vector<T> &value, std::string_view delimiters,
+                           std::size_t threads) {
+  std::string_view failed;
+  if (!detail::try_parse_parallel(tokens, count, value, delimiters, threads,
+                                  failed))
+    throw argument_incorrect_type{std::string{failed}, detail::nameof<T>()};
+}
+
+template <typename T> inline T parse(std::string_view text) {
+  T res{};
+  parse(text, res);
+  return res;
+}
+
+namespace detail {
+struct ShellToken {
+  std::string &buffer;
+  const char *start;
+  std::size_t size, offset;
+  bool copied;
+
+  void append(const char *first, const char *last) {
+    if (first == last)
+      return;
+    if (!copied && (size == 0 || start + size == first)) {
+      start = size == 0 ? first : start;
+      size += static_cast<std::size_t>(last - first);
+      return;
+    }
+    if (!copied) {
+      offset = buffer.size();
+      buffer.append(start, size);
+      copied = true;
+    }
+    buffer.append(first, last);
+  }
+};
+
+inline ParseException shell_error(const char *message, const char *first,
+                                  const char *end) {
+  const char *line = std::find(first, end, '\n');
+  return ParseException(std::string{message} + " in '" +
+                        std::string{first, line} + "'");
+}
+
+inline const char *shell_quoted(ShellToken &token, const char *first,
+                                const char *it, const char *end) {
+  while (true) {
+    const char *special = find_shell_special(it, end, true);
+    token.append(it, special);
+    it = special;
+    if (it == end || (*it == '\\' && it + 1 == end))
+      throw shell_error("Unterminated quote", first, end);
+    else if (*it == '"')
+      return it + 1;
+
+    const char next = it[1];
+    if (next == '"' || next == '\\' || next == '$' || next == '`') {
+      token.append(it + 1, it + 2);
+      it += 2;
+    } else if (next == '\n') {
+      it += 2;
+    } else {
+      token.append(it, it + 1);
+      ++it;
+    }
+  }
+}
+
+inline std::string_view next_shell_token(const char *&it, const char *end,
+                                         std::string &buffer) {
+  const char *first = it;
+  ShellToken token{buffer, it, 0, 0, false};
+  while (it != end && !is_shell_space(*it)) {
+    const char *special = find_shell_special(it, end, false);
+    token.append(it, special);
+    it = special;
+    if (it == end || is_shell_space(*it)) {
+      break;
+    } else if (*it == '\\') {
+      if (++it == end)
+        throw shell_error("Unterminated escape", first, end);
+      if (*it != '\n')
+        token.append(it, it + 1);
+      ++it;
+    } else if (*it == '\'') {
+      const auto *close = static_cast<const char *>(
+          std::memchr(it + 1, '\'', static_cast<std::size_t>(end - it - 1)));
+      if (close == nullptr)
+        throw shell_error("Unterminated quote", first, end);
+      token.append(it + 1, close);
+      it = close + 1;
+    } else {
+      it = shell_quoted(token, first, it + 1, end);
+    }
+  }
+
+  if (token.copied)
+    return {buffer.data() + token.offset, buffer.size() - token.offset};
+  return {token.start, token.size};
+}
+
+class MappedFile {
+public:
+  explicit MappedFile(const std::string &path) : data_(nullptr), size_(0) {
+#ifdef ARGPARSE_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat info;
+    if (fd < 0 || ::fstat(fd, &info) != 0) {
+      const int error = errno;
+      if (fd >= 0)
+        ::close(fd);
+      throw ParseException("Unable to read response file '" + path +
+                           "': " + std::generic_category().message(error));
+    }
+    device_ = info.st_dev;
+    inode_  = info.st_ino;
+    size_   = static_cast<std::size_t>(info.st_size);
+    if (size_ != 0) {
+      void *data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      const int error = errno;
+      ::close(fd);
+      if (data == MAP_FAILED)
+        throw ParseException("Unable to map response file '" + path +
+                             "': " + std::generic_category().message(error));
+      ::madvise(data, size_, MADV_SEQUENTIAL);
+      data_ = static_cast<const char *>(data);
+    } else {
+      ::close(fd);
+    }
+#else
+    path_ = path;
+    std::FILE *file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr)
+      throw ParseException("Unable to read response file '" + path + "'");
+    std::string contents;
+    char chunk[1 << 14];
+    std::size_t count;
+    while ((count = std::fread(chunk, 1, sizeof(chunk), file)) != 0)
+      contents.append(chunk, count);
+    std::fclose(file);
+    size_     = contents.size();
+    contents_ = std::make_unique<char[]>(size_);
+    std::memcpy(contents_.get(), contents.data(), size_);
+    data_ = contents_.get();
+#endif
+  }
+  MappedFile(MappedFile &&other) noexcept
+      : data_(std::exchange(other.data_, nullptr)),
+        size_(std::exchange(other.size_, 0)),
+#ifdef ARGPARSE_MMAP
+        device_(other.device_), inode_(other.inode_) {
+  }
+#else
+        path_(std::move(other.path_)), contents_(std::move(other.contents_)) {
+  }
+#endif
+  MappedFile &operator=(MappedFile &&) = delete;
+  ~MappedFile() {
+#ifdef ARGPARSE_MMAP
+    if (data_ != nullptr)
+      ::munmap(const_cast<char *>(data_), size_);
+#endif
+  }
+
+  inline std::string_view view() const { return {data_, size_}; }
+  inline bool same(const MappedFile &other) const {
+#ifdef ARGPARSE_MMAP
+    return device_ == other.device_ && inode_ == other.inode_;
+#else
+    return path_ == other.path_;
+#endif
+  }
+
+private:
+  const char *data_;
+  std::size_t size_;
+#ifdef ARGPARSE_MMAP
+  dev_t device_;
+  ino_t inode_;
+#else
+  std::string path_;
+  std::unique_ptr<char[]> contents_;
+#endif
+};
+
+class ConfigFile {
+public:
+  explicit ConfigFile(const std::string &path) : path_(path), file_(path) {
+    const std::string_view text = file_.view();
+    const char *it = text.data(), *const end = text.data() + text.size();
+    skip(it, end);
+    if (it != end && *it == '{')
+      json_object(it, end, {});
+    else
+      ini(it, end);
+    skip(it, end);
+    if (it != end)
+      error("Unexpected trailing content", it);
+    std::stable_sort(entries_.begin(), entries_.end(),
+                     [](const Entry &lhs, const Entry &rhs) {
+                       return lhs.key < rhs.key;
+                     });
+  }
+  ConfigFile(const ConfigFile &)            = delete;
+  ConfigFile &operator=(const ConfigFile &) = delete;
+
+  const std::string_view *find(std::string_view key,
+                               std::size_t &count) const {
+    auto it = std::upper_bound(
+        entries_.begin(), entries_.end(), key,
+        [](std::string_view lhs, const Entry &rhs) { return lhs < rhs.key; });
+    if (it == entries_.begin() || (--it)->key != key)
+      return nullptr;
+    count = it->count;
+    return items_.data() + it->first;
+  }
+
+private:
+  struct Entry {
+    std::string_view key;
+    std::size_t first, count;
+  };
+
+  [[noreturn]] void error(const char *message, const char *at) const {
+    const std::string_view text = file_.view();
+    const std::size_t line =
+        1 + static_cast<std::size_t>(std::count(text.data(), at, '\n'));
+    throw ParseException(std::string{message} + " in config file '" + path_ +
+                         "' at line " + std::to_string(line));
+  }
+
+  static void skip(const char *&it, const char *end) {
+    while (it != end && std::isspace(static_cast<unsigned char>(*it)))
+      ++it;
+  }
+  static void blank(const char *&it, const char *end) {
+    while (it != end && (*it == ' ' || *it == '\t'))
+      ++it;
+  }
+  static std::string_view trim(const char *first, const char *last) {
+    while (first != last && std::isspace(static_cast<unsigned char>(*first)))
+      ++first;
+    while (last != first &&
+           std::isspace(static_cast<unsigned char>(last[-1])))
+      --last;
+    return {first, static_cast<std::size_t>(last - first)};
+  }
+
+  void add(std::string_view prefix, std::string_view key, std::size_t first) {
+    if (!prefix.empty()) {
+      std::string joined;
+      joined.reserve(prefix.size() + 1 + key.size());
+      joined.append(prefix).append(1, '.').append(key);
+      key = strings_.store(joined);
+    }
+    entries_.push_back({key, first, items_.size() - first});
+  }
+
+  char32_t hex(const char *&it, const char *end, std::size_t digits,
+               const char *escape) const {
+    char32_t cp = 0;
+    for (std::size_t i = 0; i < digits; ++i, ++it) {
+      if (it == end || !std::isxdigit(static_cast<unsigned char>(*it)))
+        error("Invalid escape sequence", escape);
+      const int digit = *it <= '9' ? *it - '0' : (*it | 0x20) - 'a' + 10;
+      cp              = cp * 16 + static_cast<char32_t>(digit);
+    }
+    return cp;
+  }
+
+  std::string_view quoted(const char *&it, const char *end) {
+    const char quote = *it++;
+    const char *first = it;
+    bool escaped      = false;
+    while (it != end && *it != quote && *it != '\n') {
+      if (*it == '\\' && quote == '"') {
+        escaped = true;
+        if (++it == end)
+          break;
+      }
+      ++it;
+    }
+    if (it == end || *it != quote)
+      error("Unterminated string", first);
+    const std::string_view raw(first, static_cast<std::size_t>(it - first));
+    ++it;
+    if (!escaped)
+      return raw;
+
+    std::string value;
+    value.reserve(raw.size());
+    for (const char *at = raw.data(), *last = at + raw.size(); at != last;) {
+      if (*at != '\\') {
+        value += *at++;
+        continue;
+      }
+      const char *escape = at++;
+      switch (*at++) {
+      case '"':
+      case '\\':
+      case '/':
+        value += at[-1];
+        break;
+      case 'b':
+        value += '\b';
+        break;
+      case 'f':
+        value += '\f';
+        break;
+      case 'n':
+        value += '\n';
+        break;
+      case 'r':
+        value += '\r';
+        break;
+      case 't':
+        value += '\t';
+        break;
+      case 'u':
+      case 'U': {
+        char32_t cp = hex(at, last, at[-1] == 'u' ? 4u : 8u, escape);
+        if (cp >= 0xD800 && cp < 0xDC00) {
+          if (last - at < 2 || at[0] != '\\' || at[1] != 'u')
+            error("Unpaired surrogate in escape sequence", escape);
+          at += 2;
+          const char32_t low = hex(at, last, 4, escape);
+          if (low < 0xDC00 || low >= 0xE000)
+            error("Unpaired surrogate in escape sequence", escape);
+          cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+        } else if ((cp >= 0xDC00 && cp < 0xE000) || cp > 0x10FFFF) {
+          error("Invalid code point in escape sequence", escape);
+        }
+        encode_utf8(value, cp);
+        break;
+      }
+      default:
+        error("Invalid escape sequence", escape);
+      }
+    }
+    return strings_.store(value);
+  }
+
+  void ini(const char *&it, const char *end) {
+    std::string_view section;
+    while (it != end) {
+      skip(it, end);
+      if (it == end)
+        break;
+      const char *eol = std::find(it, end, '\n');
+      if (*it == '#' || *it == ';') {
+        it = eol;
+        continue;
+      }
+      if (*it == '[') {
+        const char *close = std::find(it, eol, ']');
+        if (close == eol)
+          error("Unterminated section", it);
+        section = trim(it + 1, close);
+        it      = close + 1;
+        blank(it, eol);
+        if (it != eol && *it != '#' && *it != ';' && *it != '\r')
+          error("Unexpected content after section", it);
+        it = eol;
+        continue;
+      }
+
+      const char *eq = std::find(it, eol, '=');
+      if (eq == eol)
+        error("Expected '='", it);
+      const std::string_view key = trim(it, eq);
+      if (key.empty())
+        error("Empty key", it);
+      it = eq + 1;
+      blank(it, eol);
+
+      const std::size_t first = items_.size();
+      if (it != eol && *it == '[') {
+        ++it;
+        while (true) {
+          blank(it, eol);
+          if (it == eol)
+            error("Unterminated array", eq);
+          if (*it == ']') {
+            ++it;
+            break;
+          }
+          items_.push_back(ini_value(it, eol, ",]"));
+          blank(it, eol);
+          if (it != eol && *it == ',')
+            ++it;
+        }
+      } else {
+        items_.push_back(ini_value(it, eol, {}));
+      }
+      add(section, key, first);
+
+      blank(it, eol);
+      if (it != eol && *it != '#' && *it != ';' && *it != '\r')
+        error("Unexpected content after value", it);
+      it = eol;
+    }
+  }
+
+  std::string_view ini_value(const char *&it, const char *eol,
+                             std::string_view stops) {
+    if (it != eol && (*it == '"' || *it == '\''))
+      return quoted(it, eol);
+    const char *first = it;
+    while (it != eol && stops.find(*it) == std::string_view::npos &&
+           !((*it == '#' || *it == ';') &&
+             (it == first || it[-1] == ' ' || it[-1] == '\t')))
+      ++it;
+    return trim(first, it);
+  }
+
+  void json_object(const char *&it, const char *end, std::string_view prefix) {
+    ++it;
+    skip(it, end);
+    if (it != end && *it == '}') {
+      ++it;
+      return;
+    }
+    while (true) {
+      skip(it, end);
+      if (it == end || *it != '"')
+        error("Expected a key", it);
+      const std::string_view key = quoted(it, end);
+      skip(it, end);
+      if (it == end || *it != ':')
+        error("Expected ':'", it);
+      ++it;
+      skip(it, end);
+      if (it != end && *it == '{') {
+        if (prefix.empty()) {
+          json_object(it, end, key);
+        } else {
+          std::string nested;
+          nested.append(prefix).append(1, '.').append(key);
+          json_object(it, end, strings_.store(nested));
+        }
+      } else {
+        const std::size_t first = items_.size();
+        const bool array        = it != end && *it == '[';
+        if (array) {
+          ++it;
+          skip(it, end);
+          while (it != end && *it != ']') {
+            json_scalar(it, end);
+            skip(it, end);
+            if (it != end && *it == ',') {
+              ++it;
+              skip(it, end);
+            } else if (it == end || *it != ']') {
+              error("Expected ',' or ']'", it);
+            }
+          }
+          if (it == end)
+            error("Unterminated array", it);
+          ++it;
+        } else {
+          json_scalar(it, end);
+        }
+        if (array || items_.size() != first)
+          add(prefix, key, first);
+      }
+      skip(it, end);
+      if (it != end && *it == ',') {
+        ++it;
+        continue;
+      }
+      if (it == end || *it != '}')
+        error("Expected ',' or '}'", it);
+      ++it;
+      return;
+    }
+  }
+
+  void json_scalar(const char *&it, const char *end) {
+    if (it == end)
+      error("Expected a value", it);
+    if (*it == '{' || *it == '[')
+      error("Nested values are not supported in arrays", it);
+    if (*it == '"') {
+      items_.push_back(quoted(it, end));
+      return;
+    }
+    const char *first = it;
+    while (it != end && *it != ',' && *it != '}' && *it != ']' &&
+           !std::isspace(static_cast<unsigned char>(*it)))
+      ++it;
+    const std::string_view value(first, static_cast<std::size_t>(it - first));
+    if (value.empty())
+      error("Expected a value", first);
+    if (value != "null")
+      items_.push_back(value);
+  }
+
+  std::string path_;
+  MappedFile file_;
+  StringArena strings_;
+  std::vector<std::string_view> items_;
+  std::vector<Entry> entries_;
+};
+} // namespace detail
+
+class Tokenizer {
+public:
+  const std::vector<std::string_view> &operator()(std::string_view line) {
+    tokens_.clear();
+    buffer_.clear();
+    buffer_.reserve(line.size());
+    const char *it = line.data(), *const end = line.data() + line.size();
+    while (true) {
+      while (it != end && detail::is_shell_space(*it))
+        ++it;
+      if (it == end)
+        break;
+      tokens_.push_back(detail::next_shell_token(it, end, buffer_));
+    }
+    return tokens_;
+  }
+
+  inline const std::vector<std::string_view> &tokens() const {
+    return tokens_;
+  }
+
+private:
+  std::vector<std::string_view> tokens_;
+  std::string buffer_;
+};
+
+#ifdef ARGPARSE_INSTRUMENTATION
+class CountingResource : public std::pmr::memory_resource {
+public:
+  explicit CountingResource(std::pmr::memory_resource *upstream =
+                                std::pmr::get_default_resource())
+      : upstream_(upstream), allocations_(0), bytes_(0) {}
+
+  inline std::size_t allocations() const {
+    return allocations_.load(std::memory_order_relaxed);
+  }
+  inline std::size_t bytes() const {
+    return bytes_.load(std::memory_order_relaxed);
+  }
+  inline std::pmr::memory_resource *upstream() const { return upstream_; }
+
+private:
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+    void *res = upstream_->allocate(bytes, alignment);
+    allocations_.fetch_add(1, std::memory_order_relaxed);
+    bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    return res;
+  }
+  void do_deallocate(void *p, std::size_t bytes,
+                     std::size_t alignment) override {
+    upstream_->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(const std::pmr::memory_resource &other) const
+      noexcept override {
+    return this == &other;
+  }
+
+  std::pmr::memory_resource *upstream_;
+  std::atomic<std::size_t> allocations_, bytes_;
+};
+
+struct Event {
+  enum Kind : std::uint8_t {
+    add_argument,
+    compile,
+    parse,
+    tokenize,
+    convert,
+    validate,
+    collect,
+    help
+  };
+
+  Kind kind;
+  std::string_view parser, argument;
+  std::size_t count;
+  std::chrono::steady_clock::time_point start;
+  std::chrono::steady_clock::duration elapsed;
+  std::size_t allocations, bytes;
+};
+
+class Observer {
+public:
+  virtual ~Observer()                    = default;
+  virtual void record(const Event &event) = 0;
+};
+
+class ChromeTrace : public Observer {
+public:
+  ChromeTrace() : origin_(std::chrono::steady_clock::now()) {}
+
+  void record(const Event &event) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = threads_.find(std::this_thread::get_id());
+    if (it == threads_.end())
+      it = threads_.emplace(std::this_thread::get_id(), threads_.size()).first;
+    events_.push_back({event.kind, std::string{event.parser},
+                       std::string{event.argument}, event.count, event.start,
+                       event.elapsed, event.allocations, event.bytes,
+                       it->second});
+  }
+
+  std::size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return events_.size();
+  }
+  void clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_.clear();
+  }
+
+  void write(std::ostream &os) const {
+    static constexpr std::string_view kinds[] = {
+        "add_argument", "compile", "parse", "tokenize",
+        "convert",      "validate", "collect", "help"};
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string out = "{\"traceEvents\":[";
+    for (std::size_t i = 0; i < events_.size(); ++i) {
+      const Entry &entry = events_[i];
+      if (i != 0)
+        out += ',';
+      out += "\n{\"name\":\"";
+      escape(out, entry.argument.empty() ? entry.parser : entry.argument);
+      out += "\",\"cat\":\"";
+      out += kinds[entry.kind];
+      out += "\",\"ph\":\"X\",\"ts\":";
+      out += std::to_string(microseconds(entry.start - origin_));
+      out += ",\"dur\":";
+      out += std::to_string(microseconds(entry.elapsed));
+      out += ",\"pid\":1,\"tid\":";
+      out += std::to_string(entry.thread);
+      out += ",\"args\":{\"parser\":\"";
+      escape(out, entry.parser);
+      out += "\",\"count\":" + std::to_string(entry.count);
+      out += ",\"allocations\":" + std::to_string(entry.allocations);
+      out += ",\"bytes\":" + std::to_string(entry.bytes) + "}}";
+    }
+    out += "\n]}\n";
+    os.write(out.data(), static_cast<std::streamsize>(out.size()));
+  }
+
+private:
+  struct Entry {
+    Event::Kind kind;
+    std::string parser, argument;
+    std::size_t count;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::duration elapsed;
+    std::size_t allocations, bytes, thread;
+  };
+
+  static double microseconds(std::chrono::steady_clock::duration elapsed) {
+    return std::chrono::duration<double, std::micro>(elapsed).count();
+  }
+  static void escape(std::string &out, std::string_view text) {
+    static constexpr char hex[] = "0123456789abcdef";
+    for (char c : text) {
+      const auto byte = static_cast<unsigned char>(c);
+      if (c == '"' || c == '\\') {
+        out += '\\';
+        out += c;
+      } else if (byte < 0x20) {
+        out += "\\u00";
+        out += hex[byte >> 4];
+        out += hex[byte & 0xF];
+      } else {
+        out += c;
+      }
+    }
+  }
+
+  std::chrono::steady_clock::time_point origin_;
+  mutable std::mutex mutex_;
+  std::vector<Entry> events_;
+  std::unordered_map<std::thread::id, std::size_t> threads_;
+};
+
+namespace detail {
+class Span {
+public:
+  Span(Observer *observer, Event::Kind kind, std::string_view parser,
+       std::string_view argument = {}, std::size_t count = 0,
+       std::pmr::memory_resource *resource = nullptr)
+      : observer_(observer), counting_(nullptr),
+        event_{kind, parser, argument, count, {}, {}, 0, 0} {
+    if (observer_ == nullptr)
+      return;
+    counting_ = dynamic_cast<CountingResource *>(resource);
+    if (counting_ != nullptr) {
+      event_.allocations = counting_->allocations();
+      event_.bytes       = counting_->bytes();
+    }
+    event_.start = std::chrono::steady_clock::now();
+  }
+  Span(const Span &)            = delete;
+  Span &operator=(const Span &) = delete;
+  ~Span() {
+    if (observer_ == nullptr)
+      return;
+    event_.elapsed = std::chrono::steady_clock::now() - event_.start;
+    if (counting_ != nullptr) {
+      event_.allocations = counting_->allocations() - event_.allocations;
+      event_.bytes       = counting_->bytes() - event_.bytes;
+    }
+    observer_->record(event_);
+  }
+
+private:
+  Observer *observer_;
+  CountingResource *counting_;
+  Event event_;
+};
+} // namespace detail
+#endif
+
+class Value {
+public:
+  template <typename T>
+  Value(const T &value, std::uint8_t count = 0)
+      : value_{std::move(value)}, count_{std::move(count)} {}
+  Value(std::any value, std::uint8_t count)
+      : value_{std::move(value)}, count_{count} {}
+
+  template <typename T> inline T as() const { return std::any_cast<T>(value_); }
+  inline std::uint8_t count() const { return count_; }
+  inline const std::any get() const { return value_; }
+
+  inline operator bool() const {
+    if (!value_.has_value())
+      return false;
+    else if (value_.type() == typeid(bool))
+      return std::any_cast<bool>(value_);
+    return true;
+  }
+
+  template <typename T>
+  inline auto operator==(const T &rhs) const -> decltype(rhs == rhs) {
+    return std::any_cast<T>(value_) == rhs;
+  }
+  template <typename T>
+  inline auto operator!=(const T &rhs) const -> decltype(rhs != rhs) {
+    return std::any_cast<T>(value_) != rhs;
+  }
+  template <typename T>
+  inline auto operator<(const T &rhs) const -> decltype(rhs < rhs) {
+    return std::any_cast<T>(value_) < rhs;
+  }
+  template <typename T>
+  inline auto operator>(const T &rhs) const -> decltype(rhs > rhs) {
+    return std::any_cast<T>(value_) > rhs;
+  }
+  template <typename T>
+  inline auto operator<=(const T &rhs) const -> decltype(rhs <= rhs) {
+    return std::any_cast<T>(value_) <= rhs;
+  }
+  template <typename T>
+  inline auto operator>=(const T &rhs) const -> decltype(rhs >= rhs) {
+    return std::any_cast<T>(value_) >= rhs;
+  }
+
+protected:
+  friend class Result;
+
+  std::any value_;
+  std::uint8_t count_;
+};
+
+class ArgumentParser;
+class Result;
+class TypedResult;
+
+template <typename T> class ArgHandle {
+public:
+  ArgHandle() : layout_(nullptr), index_(0), offset_(0) {}
+
+private:
+  friend class Result;
+  friend class TypedResult;
+  template <typename> friend class Argument;
+
+  ArgHandle(const detail::Layout *layout, std::size_t index,
+            std::size_t offset)
+      : layout_(layout), index_(index), offset_(offset) {}
+
+  const detail::Layout *layout_;
+  std::size_t index_, offset_;
+};
+
+class Result {
+public:
+  Result() : Result(std::pmr::get_default_resource()) {}
+  explicit Result(std::pmr::memory_resource *resource)
+      : keys_(resource), index_(resource), values_(resource),
+        segments_(resource) {}
+  Result(const Result &other,
+         std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+      : keys_(resource), index_(resource),
+        values_(other.values_.begin(), other.values_.end(), resource),
+        segments_(other.segments_.begin(), other.segments_.end(), resource) {
+    index_.reserve(other.index_.size());
+    for (const auto &it : other.index_)
+      if (it.second != npos)
+        index_.emplace(keys_.store(it.first), it.second);
+  }
+  Result(Result &&) = default;
+
+  Result &operator=(const Result &other) {
+    if (this != &other) {
+      Result copy(other, resource());
+      *this = std::move(copy);
+    }
+    return *this;
+  }
+  Result &operator=(Result &&) = default;
+
+  template <typename T> inline T get(std::string_view key) const {
+    return at(key).as<T>();
+  }
+  template <typename T> inline T get(const ArgHandle<T> &handle) const {
+    return at(handle).template as<T>();
+  }
+  inline const Value &operator[](std::string_view key) const {
+    return at(key);
+  }
+  template <typename T>
+  inline const Value &operator[](const ArgHandle<T> &handle) const {
+    return at(handle);
+  }
+  inline std::uint8_t count(std::string_view key) const {
+    return at(key).count();
+  }
+  template <typename T>
+  inline std::uint8_t count(const ArgHandle<T> &handle) const {
+    return at(handle).count();
+  }
+  inline bool has(std::string_view key) const {
+    auto it = index_.find(key);
+    return it != index_.end() && it->second != npos;
+  }
+  template <typename T> inline bool has(const ArgHandle<T> &handle) const {
+    return find(handle) != nullptr;
+  }
+
+  inline void insert(std::string_view key, Value value) {
+    if (!has(key))
+      assign(key, std::move(value));
+  }
+
+  template <typename T>
+  inline void insert(std::string_view key, const T &value) {
+    insert(key, Value{std::move(value)});
+  }
+
+  inline std::pmr::memory_resource *resource() const {
+    return values_.get_allocator().resource();
+  }
+
+  void clear() noexcept {
+    for (auto &it : index_)
+      it.second = npos;
+    values_.clear();
+    segments_.clear();
+  }
+
+private:
+  friend class ArgumentParser;
+
+  static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+  struct Segment {
+    const detail::Layout *layout;
+    std::size_t base, size;
+  };
+
+  const Value &at(std::string_view key) const {
+    auto it = index_.find(key);
+    if (it == index_.end() || it->second == npos)
+      throw std::out_of_range("Argument '" + std::string{key} +
+                              "' is not present in the result");
+    return values_[it->second];
+  }
+  template <typename T> const Value &at(const ArgHandle<T> &handle) const {
+    const Value *value = find(handle);
+    if (value == nullptr)
+      throw std::out_of_range("Argument is not present in the result");
+    return *value;
+  }
+  template <typename T> const Value *find(const ArgHandle<T> &handle) const {
+    for (const auto &segment : segments_) {
+      if (segment.layout != handle.layout_ || handle.index_ >= segment.size)
+        continue;
+      const Value &value = values_[segment.base + handle.index_];
+      return value.value_.has_value() ? &value : nullptr;
+    }
+    return nullptr;
+  }
+
+  void assign(std::string_view key, Value value) {
+    auto it = index_.find(key);
+    if (it == index_.end())
+      it = index_.emplace(keys_.store(key), npos).first;
+    if (it->second != npos) {
+      values_[it->second] = std::move(value);
+    } else {
+      it->second = values_.size();
+      values_.push_back(std::move(value));
+    }
+  }
+
+  detail::StringArena keys_;
+  std::pmr::unordered_map<std::string_view, std::size_t> index_;
+  std::pmr::vector<Value> values_;
+  std::pmr::vector<Segment> segments_;
+  detail::resource_ptr<TypedResult> scratch_;
+};
+
+class TypedResult {
+public:
+  explicit TypedResult(
+      std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+      : storage_(resource), present_(resource), counts_(resource),
+        tokens_(resource) {}
+  explicit TypedResult(
+      std::shared_ptr<const detail::Layout> layout,
+      std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+      : layout_(std::move(layout)),
+        storage_((layout_->size + sizeof(std::max_align_t) - 1) /
+                     sizeof(std::max_align_t),
+                 resource),
+        present_(layout_->slots.size(), false, resource),
+        counts_(layout_->slots.size(), 0, resource), tokens_(resource) {}
+  TypedResult(
+      const TypedResult &other,
+      std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+      : layout_(other.layout_), storage_(other.storage_.size(), resource),
+        present_(other.present_, resource), counts_(other.counts_, resource),
+        tokens_(resource) {
+    for (std::size_t i = 0; i < present_.size(); ++i) {
+      if (present_[i]) {
+        const std::size_t offset = layout_->slots[i].offset;
+        layout_->slots[i].copy(data() + offset, other.data() + offset);
+      }
+    }
+    if (other.subcommand_)
+      subcommand_ = detail::make_resource_ptr<TypedResult>(
+          resource, *other.subcommand_, resource);
+  }
+  TypedResult(TypedResult &&other) noexcept = default;
+  ~TypedResult() { clear(); }
+
+  TypedResult &operator=(const TypedResult &other) {
+    if (this != &other) {
+      TypedResult copy(other, resource());
+      *this = std::move(copy);
+    }
+    return *this;
+  }
+  TypedResult &operator=(TypedResult &&other) {
+    if (this != &other && resource() != other.resource()) {
+      *this = static_cast<const TypedResult &>(other);
+    } else if (this != &other) {
+      clear();
+      layout_     = std::move(other.layout_);
+      storage_    = std::move(other.storage_);
+      present_    = std::move(other.present_);
+      counts_     = std::move(other.counts_);
+      tokens_     = std::move(other.tokens_);
+      subcommand_ = std::move(other.subcommand_);
+    }
+    return *this;
+  }
+
+  template <typename T> inline bool has(const ArgHandle<T> &handle) const {
+    const TypedResult *res = resolve(handle.layout_);
+    return res != nullptr && handle.index_ < res->present_.size() &&
+           res->present_[handle.index_];
+  }
+  template <typename T> inline const T &get(const ArgHandle<T> &handle) const {
+    const TypedResult *res = resolve(handle.layout_);
+    if (res == nullptr || handle.index_ >= res->present_.size() ||
+        !res->present_[handle.index_])
+      throw std::out_of_range("Argument is not present in the result");
+    return *std::launder(
+        reinterpret_cast<const T *>(res->data() + handle.offset_));
+  }
+  template <typename T>
+  inline std::uint8_t count(const ArgHandle<T> &handle) const {
+    return has(handle) ? resolve(handle.layout_)->counts_[handle.index_] : 0;
+  }
+
+  inline std::string_view command() const {
+    return layout_ ? std::string_view{layout_->name} : std::string_view{};
+  }
+  inline std::pmr::memory_resource *resource() const {
+    return storage_.get_allocator().resource();
+  }
+  inline const TypedResult *subcommand() const { return subcommand_.get(); }
+
+  void clear() noexcept {
+    for (std::size_t i = 0; i < present_.size(); ++i) {
+      if (present_[i])
+        layout_->slots[i].destroy(data() + layout_->slots[i].offset);
+      present_[i] = false;
+      counts_[i]  = 0;
+    }
+    subcommand_.reset();
+  }
+
+private:
+  friend class ArgumentParser;
+  template <typename> friend class Argument;
+
+  inline std::byte *data() {
+    return reinterpret_cast<std::byte *>(storage_.data());
+  }
+  inline const std::byte *data() const {
+    return reinterpret_cast<const std::byte *>(storage_.data());
+  }
+
+  const TypedResult *resolve(const detail::Layout *layout) const {
+    const TypedResult *res = this;
+    while (res != nullptr && res->layout_.get() != layout)
+      res = res->subcommand_.get();
+    return res;
+  }
+
+  template <typename T> T *slot(std::size_t index, std::size_t offset) {
+    if (!present_[index])
+      return nullptr;
+    return std::launder(reinterpret_cast<T *>(data() + offset));
+  }
+  template <typename T, typename... Args>
+  T &emplace(std::size_t index, std::size_t offset, Args &&...args) {
+    T *ptr          = new (data() + offset) T(std::forward<Args>(args)...);
+    present_[index] = true;
+    return *ptr;
+  }
+
+  std::shared_ptr<const detail::Layout> layout_;
+  std::pmr::vector<std::max_align_t> storage_;
+  std::pmr::vector<bool> present_;
+  std::pmr::vector<std::uint8_t> counts_;
+  std::pmr::vector<std::string_view> tokens_;
+  detail::resource_ptr<TypedResult> subcommand_;
+};
+
+enum class ErrorCode : std::uint8_t {
+  none,
+  ambiguous_argument,
+  unrecognized_argument,
+  missing_value,
+  missing_argument,
+  invalid_value,
+  response_file,
+  recursive_response_file,
+  config_file,
+  invalid_choice,
+  out_of_range,
+  mutually_exclusive,
+  missing_group,
+  missing_dependency
+};
+
+class ArgumentBase {
+public:
+  virtual ~ArgumentBase() = default;
+
+  std::string get_usage() const {
+    std::string res;
+    write_usage(res);
+    return res;
+  }
+  std::string get_help_key() const {
+    std::string res;
+    write_help_key(res);
+    return res;
+  }
+  std::string get_help() const {
+    std::string res;
+    write_help(res);
+    return res;
+  }
+
+  virtual void write_usage(std::string &out) const {
+    const std::size_t start = out.size();
+    if (!is_required_)
+      out += '[';
+    if (!is_positional_)
+      out += names_.back();
+
+    if (nargs_ > 0) {
+      for (std::int8_t i = 0; i < nargs_; ++i)
+        write_meta(out += ' ');
+    } else if (nargs_ == -1) {
+      write_meta(out += " [") += ']';
+    } else if (nargs_ == -2) {
+      write_meta(write_meta(out += ' ') += " [") += " ...]";
+    } else if (nargs_ == -3) {
+      write_meta(write_meta(out += " [") += " [") += " ...]]";
+    }
 
-  virtual std::string get_help() const { return description_; }
+    if (!is_required_)
+      out += ']';
+    if (out.size() > start && out[start] == ' ')
+      out.erase(start, 1);
+  }
+
+  virtual void write_help_key(std::string &out) const {
+    if (description_.empty())
+      return;
+    if (!is_positional_) {
+      for (std::size_t i = 0; i < names_.size(); ++i) {
+        out += names_[i];
+        if (i != names_.size() - 1)
+          out += ", ";
+      }
+    }
+    if (nargs_ != 0)
+      write_meta(out += ' ');
+  }
+
+  virtual void write_help(std::string &out) const { out += description_; }
+
+  std::size_t help_key_length() const {
+    if (description_.empty())
+      return 0;
+    std::size_t length = 0;
+    if (!is_positional_) {
+      for (const auto &name : names_)
+        length += detail::display_width(name);
+      length += 2 * (names_.size() - 1);
+    }
+    if (nargs_ != 0)
+      length += 1 + detail::display_width(key());
+    return length;
+  }
 
   virtual ArgumentBase &group(std::string group) {
     group_ = std::move(group);
+    touch();
     return *this;
   }
   virtual ArgumentBase &help(std::string help) {
     description_ = std::move(help);
+    touch();
     return *this;
   }
   virtual ArgumentBase &description(std::string description) {
     description_ = std::move(description);
+    touch();
     return *this;
   }
   virtual ArgumentBase &nargs(std::int8_t nargs) {
@@ -361,25 +2252,46 @@ public:
       nargs_ = -2;
     else if (nargs == '*')
       nargs_ = -3;
-    nargs_ = nargs;
+    else
+      nargs_ = nargs;
+    touch();
     return *this;
   }
   virtual ArgumentBase &required(bool required = true) {
     is_required_ = required;
+    touch();
     return *this;
   }
   virtual ArgumentBase &optional(bool optional = true) {
     is_required_ = !optional;
+    touch();
+    return *this;
+  }
+  virtual ArgumentBase &depends_on(std::string name) {
+    depends_.push_back(std::move(name));
+    touch();
+    return *this;
+  }
+  virtual ArgumentBase &env(std::string variable) {
+    env_ = std::move(variable);
+    touch();
+    return *this;
+  }
+  virtual ArgumentBase &config(std::string key) {
+    config_ = std::move(key);
+    touch();
     return *this;
   }
 
 protected:
   friend class ArgumentParser;
+  friend class ParseError;
 
   template <std::size_t N, std::size_t... I>
   explicit ArgumentBase(std::string_view(&&a)[N], std::index_sequence<I...>)
       : names_{}, is_positional_((detail::is_positional(a[I]) || ...)),
-        is_required_(false), nargs_(1), group_{} {
+        is_required_(false), nargs_(1), group_{}, layout_(nullptr), index_(0),
+        offset_(0), revision_(nullptr) {
     ((void)names_.emplace_back(a[I]), ...);
     std::sort(
         names_.begin(), names_.end(), [](const auto &lhs, const auto &rhs) {
@@ -390,36 +2302,82 @@ protected:
       group_       = "Positional";
     }
   }
+
+  void touch() {
+    if (revision_ != nullptr)
+      ++*revision_;
+  }
+
+  std::string_view key() const {
+    std::string_view name = names_.back();
+    return name.substr(name.find_first_not_of('-'));
+  }
+
+  std::string &write_meta(std::string &out) const {
+    for (char c : key())
+      out += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    return out;
+  }
+
+  virtual bool store_value(TypedResult &values, std::string_view token,
+                           std::string_view &failed) const = 0;
+  virtual bool store_values(TypedResult &values,
+                            const std::string_view *tokens, std::size_t count,
+                            std::string_view &failed) const {
+    for (std::size_t i = 0; i < count; ++i)
+      if (!store_value(values, tokens[i], failed))
+        return false;
+    return true;
+  }
+  virtual std::string_view type_name() const = 0;
+  virtual bool has_constraints() const = 0;
+  virtual ErrorCode check(TypedResult &values, std::string &text) const = 0;
+  virtual bool store_implicit(TypedResult &values) const = 0;
+  virtual bool store_default(TypedResult &values) const = 0;
+  virtual bool has_default() const = 0;
+  virtual bool has_sink() const = 0;
+  virtual bool is_parallel() const = 0;
+
   std::vector<std::string> names_;
   bool is_positional_, is_required_;
   std::int8_t nargs_;
   std::string group_, description_;
+  std::vector<std::string> depends_;
+  std::string env_, config_;
+  const detail::Layout *layout_;
+  std::size_t index_, offset_;
+  std::size_t *revision_;
 };
 
 template <typename T> class Argument : public ArgumentBase {
 public:
   template <std::size_t N>
   explicit Argument(std::string_view(&&a)[N])
-      : ArgumentBase(std::move(a), std::make_index_sequence<N>{}) {
+      : ArgumentBase(std::move(a), std::make_index_sequence<N>{}),
+        delimiters_(","), threads_(1) {
     if constexpr (std::is_same<T, bool>::value) {
       nargs_    = 0;
       default_  = false;
       implicit_ = true;
-    } else if constexpr (detail::is_container<T>::value) {
+    } else if constexpr (detail::is_container<T>::value &&
+                         !std::is_same<T, std::string>::value) {
       nargs_ = -2;
     }
   }
 
   Argument<T> &group(std::string group) override {
     group_ = std::move(group);
+    touch();
     return *this;
   }
   Argument<T> &help(std::string help) override {
     description_ = std::move(help);
+    touch();
     return *this;
   }
   Argument<T> &description(std::string description) override {
     description_ = std::move(description);
+    touch();
     return *this;
   }
   Argument<T> &nargs(std::int8_t nargs) override {
@@ -431,384 +2389,1768 @@ public:
       nargs_ = -2;
     else if (nargs == '*')
       nargs_ = -3;
-    nargs_ = nargs;
+    else
+      nargs_ = nargs;
+    touch();
+    return *this;
+  }
+  Argument<T> &required(bool required = true) override {
+    is_required_ = required;
+    touch();
+    return *this;
+  }
+  Argument<T> &optional(bool optional = true) override {
+    is_required_ = !optional;
+    touch();
+    return *this;
+  }
+  Argument<T> &depends_on(std::string name) override {
+    depends_.push_back(std::move(name));
+    touch();
+    return *this;
+  }
+  Argument<T> &env(std::string variable) override {
+    env_ = std::move(variable);
+    touch();
+    return *this;
+  }
+  Argument<T> &config(std::string key) override {
+    config_ = std::move(key);
+    touch();
+    return *this;
+  }
+  Argument<T> &
+  choices(std::vector<typename detail::element_type<T>::type> values) {
+    static_assert(detail::is_equality_comparable<
+                      typename detail::element_type<T>::type>::value,
+                  "choices require values that compare equal");
+    choices_ = std::move(values);
+    touch();
+    return *this;
+  }
+  Argument<T> &range(typename detail::element_type<T>::type min,
+                     typename detail::element_type<T>::type max) {
+    static_assert(
+        std::is_arithmetic<typename detail::element_type<T>::type>::value,
+        "ranges are only supported for arithmetic values");
+    range_.emplace(min, max);
+    touch();
+    return *this;
+  }
+  Argument<T> &delimiters(std::string delimiters) {
+    delimiters_ = std::move(delimiters);
+    return *this;
+  }
+  Argument<T> &
+  sink(std::function<void(typename detail::element_type<T>::type)> callback) {
+    static_assert(detail::is_vector<T>::value,
+                  "sinks are only supported for list arguments");
+    sink_ = std::move(callback);
+    touch();
+    return *this;
+  }
+  Argument<T> &parallel(std::size_t threads = 0) {
+    static_assert(detail::is_vector<T>::value &&
+                      !std::is_same<T, std::vector<bool>>::value,
+                  "parallel conversion is only supported for list arguments");
+    threads_ = threads;
+    touch();
+    return *this;
+  }
+
+  template <typename U>
+  typename std::enable_if<std::is_convertible<U, T>::value, Argument<T>>::type &
+  default_value(const U &value) {
+    default_ = static_cast<T>(value);
+    touch();
+    return *this;
+  }
+
+  template <typename U>
+  typename std::enable_if<std::is_convertible<U, T>::value, Argument<T>>::type &
+  implicit_value(const U &value) {
+    implicit_ = static_cast<T>(value);
+    touch();
+    return *this;
+  }
+
+  void write_help(std::string &out) const override {
+    out += description_;
+    if constexpr (std::is_same<T, bool>::value) {
+      if (nargs_ == 0)
+        return;
+    }
+    out += " [";
+    out += detail::nameof<T>();
+    if (default_.has_value())
+      out += "=" + detail::to_string(default_.value());
+    if (implicit_.has_value())
+      out += "(=" + detail::to_string(implicit_.value()) + ")";
+    out += ']';
+  }
+
+  ArgHandle<T> handle() const { return {layout_, index_, offset_}; }
+  operator ArgHandle<T>() const { return handle(); }
+
+protected:
+  bool store_value(TypedResult &values, std::string_view token,
+                   std::string_view &failed) const override {
+    T *value = values.slot<T>(index_, offset_);
+    if constexpr (detail::is_container<T>::value &&
+                  !std::is_same<T, std::string>::value) {
+      if (value == nullptr)
+        value = &values.emplace<T>(index_, offset_);
+      if constexpr (detail::is_vector<T>::value) {
+        if (sink_)
+          return detail::try_parse_each<typename T::value_type>(
+              token, delimiters_, sink_, failed);
+        return detail::try_parse_list(token, *value, delimiters_, failed);
+      } else {
+        failed = token;
+        return try_parse(token, *value);
+      }
+    } else {
+      T result{};
+      if (!try_parse(token, result)) {
+        failed = token;
+        return false;
+      }
+      if (value == nullptr)
+        values.emplace<T>(index_, offset_, std::move(result));
+      else
+        *value = std::move(result);
+      return true;
+    }
+  }
+  bool store_values(TypedResult &values, const std::string_view *tokens,
+                    std::size_t count,
+                    std::string_view &failed) const override {
+    if constexpr (detail::is_vector<T>::value &&
+                  !std::is_same<T, std::vector<bool>>::value) {
+      if (is_parallel()) {
+        if (count == 0)
+          return true;
+        T *value = values.slot<T>(index_, offset_);
+        if (value == nullptr)
+          value = &values.emplace<T>(index_, offset_);
+        return detail::try_parse_parallel(tokens, count, *value, delimiters_,
+                                          threads_, failed);
+      }
+    }
+    return ArgumentBase::store_values(values, tokens, count, failed);
+  }
+  std::string_view type_name() const override {
+    return detail::nameof<typename detail::element_type<T>::type>();
+  }
+  bool has_constraints() const override {
+    return !choices_.empty() || range_.has_value();
+  }
+  ErrorCode check(TypedResult &values, std::string &text) const override {
+    const T *value = values.slot<T>(index_, offset_);
+    if (value == nullptr)
+      return ErrorCode::none;
+    if constexpr (detail::is_vector<T>::value) {
+      for (const auto &item : *value)
+        if (const ErrorCode code = admits(item); code != ErrorCode::none) {
+          text = detail::to_string(item);
+          return code;
+        }
+      return ErrorCode::none;
+    } else {
+      const ErrorCode code = admits(*value);
+      if (code != ErrorCode::none)
+        text = detail::to_string(*value);
+      return code;
+    }
+  }
+  ErrorCode admits(const typename detail::element_type<T>::type &value) const {
+    using E = typename detail::element_type<T>::type;
+    if constexpr (std::is_arithmetic<E>::value) {
+      if (range_ && (value < range_->first || range_->second < value))
+        return ErrorCode::out_of_range;
+    }
+    if constexpr (detail::is_equality_comparable<E>::value) {
+      if (!choices_.empty() &&
+          std::find(choices_.begin(), choices_.end(), value) == choices_.end())
+        return ErrorCode::invalid_choice;
+    }
+    return ErrorCode::none;
+  }
+  bool store_implicit(TypedResult &values) const override {
+    return store(values, implicit_);
+  }
+  bool store_default(TypedResult &values) const override {
+    return store(values, default_);
+  }
+  bool has_default() const override { return default_.has_value(); }
+  bool has_sink() const override { return static_cast<bool>(sink_); }
+  bool is_parallel() const override { return threads_ != 1 && !sink_; }
+
+  bool store(TypedResult &values, const std::optional<T> &source) const {
+    if (!source.has_value())
+      return false;
+    T *value = values.slot<T>(index_, offset_);
+    if (value == nullptr)
+      values.emplace<T>(index_, offset_, source.value());
+    else
+      *value = source.value();
+    return true;
+  }
+
+  std::optional<T> default_, implicit_;
+  std::string delimiters_;
+  std::function<void(typename detail::element_type<T>::type)> sink_;
+  std::size_t threads_;
+  std::vector<typename detail::element_type<T>::type> choices_;
+  std::optional<std::pair<typename detail::element_type<T>::type,
+                          typename detail::element_type<T>::type>>
+      range_;
+};
+
+class ParseError {
+public:
+  static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+  ParseError()
+      : code_(ErrorCode::none), index_(npos), offset_(0), argument_(nullptr),
+        token_(nullptr), text_{} {}
+
+  explicit operator bool() const noexcept { return code_ != ErrorCode::none; }
+
+  inline ErrorCode code() const noexcept { return code_; }
+  inline std::size_t index() const noexcept { return index_; }
+  inline const ArgumentBase *argument() const noexcept { return argument_; }
+  inline std::string_view text() const noexcept { return text_; }
+
+  std::string message() const {
+    switch (code_) {
+    case ErrorCode::none:
+      return {};
+    case ErrorCode::ambiguous_argument:
+      return "Ambiguous argument '" + text_ + "'";
+    case ErrorCode::unrecognized_argument:
+      if (offset_ != 0)
+        return "Unrecognized argument '-" + std::string(1, text_[offset_]) +
+               "' in '" + text_ + "'";
+      return "Unrecognized argument '" + text_ + "'";
+    case ErrorCode::missing_value:
+      return "Argument '" + argument_->names_.back() + "' expected a value";
+    case ErrorCode::missing_argument:
+      return "Argument '" + argument_->names_.back() + "' is required";
+    case ErrorCode::invalid_value:
+      return "Argument '" + text_ + "' failed to parse as type '" +
+             std::string{argument_->type_name()} + "'";
+    case ErrorCode::response_file:
+      return text_;
+    case ErrorCode::recursive_response_file:
+      return "Response file '" + text_ + "' includes itself";
+    case ErrorCode::config_file:
+      return text_;
+    case ErrorCode::invalid_choice:
+      return "Value '" + text_ + "' is not a valid choice for argument '" +
+             argument_->names_.back() + "'";
+    case ErrorCode::out_of_range:
+      return "Value '" + text_ + "' is out of range for argument '" +
+             argument_->names_.back() + "'";
+    case ErrorCode::mutually_exclusive:
+      return "Argument '" + argument_->names_.back() +
+             "' cannot be used with '" + text_ + "'";
+    case ErrorCode::missing_group:
+      return "One of the arguments in group '" + text_ + "' is required";
+    case ErrorCode::missing_dependency:
+      return "Argument '" + argument_->names_.back() + "' requires '" + text_ +
+             "'";
+    }
+    return {};
+  }
+
+  [[noreturn]] void raise() const {
+    if (code_ == ErrorCode::invalid_value)
+      throw argument_incorrect_type{text_, argument_->type_name()};
+    throw ParseException(message());
+  }
+
+private:
+  friend class ArgumentParser;
+
+  ErrorCode code_;
+  std::size_t index_, offset_;
+  const ArgumentBase *argument_;
+  const char *token_;
+  std::string text_;
+};
+
+template <typename T> class Expected {
+public:
+  Expected(T value) : value_(std::move(value)), error_{} {}
+  Expected(ParseError error) : value_{}, error_(std::move(error)) {}
+
+  inline bool has_value() const noexcept { return value_.has_value(); }
+  explicit operator bool() const noexcept { return value_.has_value(); }
+
+  T &value() & {
+    if (!value_)
+      error_.raise();
+    return *value_;
+  }
+  const T &value() const & {
+    if (!value_)
+      error_.raise();
+    return *value_;
+  }
+  T &&value() && {
+    if (!value_)
+      error_.raise();
+    return std::move(*value_);
+  }
+
+  inline T &operator*() & { return *value_; }
+  inline const T &operator*() const & { return *value_; }
+  inline T *operator->() { return &*value_; }
+  inline const T *operator->() const { return &*value_; }
+
+  inline const ParseError &error() const noexcept { return error_; }
+
+private:
+  std::optional<T> value_;
+  ParseError error_;
+};
+
+class ArgumentParser {
+public:
+  ArgumentParser(std::string program_name = {})
+      : short_usage_(false), response_files_(false),
+        program_name_{std::move(program_name)},
+        layout_(std::make_shared<detail::Layout>(program_name_)),
+        table_{}, sorted_arguments_{}, sorted_subcommands_{}, trie_{},
+        compiled_(std::numeric_limits<std::size_t>::max()), width_(0),
+        revision_(std::make_unique<std::size_t>(0)),
+        rendered_(std::numeric_limits<std::size_t>::max()), usage_{}, help_{} {}
+
+  ArgumentParser(ArgumentParser &&) noexcept = default;
+  ArgumentParser &operator=(ArgumentParser &&) = default;
+
+  ArgumentParser &description(std::string description) {
+    description_ = std::move(description);
+    ++*revision_;
+    return *this;
+  }
+  ArgumentParser &short_description(std::string short_description) {
+    short_ = std::move(short_description);
+    ++*revision_;
+    return *this;
+  }
+  ArgumentParser &epilog(std::string epilog) {
+    epilog_ = std::move(epilog);
+    ++*revision_;
+    return *this;
+  }
+  ArgumentParser &width(std::size_t columns) {
+    width_ = columns;
+    ++*revision_;
+    return *this;
+  }
+  ArgumentParser &response_files(bool enabled = true) {
+    response_files_ = enabled;
+    return *this;
+  }
+  ArgumentParser &config_file(std::string path) {
+    config_       = std::make_unique<Config>();
+    config_->path = std::move(path);
+    return *this;
+  }
+#ifdef ARGPARSE_INSTRUMENTATION
+  ArgumentParser &observer(Observer *observer) {
+    observer_ = observer;
+    for (auto &it : subcommands_) {
+      it.observer = observer;
+      if (it.parser)
+        it.parser->observer(observer);
+    }
+    return *this;
+  }
+#endif
+
+  ArgumentParser &mutually_exclusive(std::string group,
+                                     bool required = false) {
+    rules_.push_back({std::move(group), true, required});
+    ++*revision_;
+    return *this;
+  }
+  ArgumentParser &required_group(std::string group) {
+    rules_.push_back({std::move(group), false, true});
+    ++*revision_;
+    return *this;
+  }
+
+  ArgumentParser &add_subcommand(const std::string &name,
+                                 const std::string &help) {
+    subcommands_.push_back({name, help, {}, nullptr});
+#ifdef ARGPARSE_INSTRUMENTATION
+    subcommands_.back().observer = observer_;
+#endif
+    ++*revision_;
+    return subcommands_.back().get();
+  }
+  ArgumentParser &
+  add_subcommand(std::string name, std::string help,
+                 std::function<void(ArgumentParser &)> builder) {
+    subcommands_.push_back(
+        {std::move(name), std::move(help), std::move(builder), nullptr});
+#ifdef ARGPARSE_INSTRUMENTATION
+    subcommands_.back().observer = observer_;
+#endif
+    ++*revision_;
+    return *this;
+  }
+
+  ArgumentParser &subcommand(std::string_view name) {
+    compile();
+    const Subcommand *entry = find_subcommand(name);
+    if (entry == nullptr)
+      throw std::out_of_range("Subcommand '" + std::string{name} +
+                              "' is not defined");
+    return entry->get();
+  }
+
+  template <typename T = bool, typename... Args>
+  Argument<T> &add_argument(Args... args) {
+    using array_of_sv = std::string_view[sizeof...(Args)];
+#ifdef ARGPARSE_INSTRUMENTATION
+    detail::Span span(observer_, Event::add_argument, program_name_,
+                      array_of_sv{args...}[sizeof...(Args) - 1]);
+#endif
+    auto argument = std::make_unique<Argument<T>>(array_of_sv{args...});
+    const auto index = static_cast<std::uint32_t>(arguments_.size());
+    if (!argument->is_positional_) {
+      for (auto it = argument->names_.begin(); it != argument->names_.end();
+           ++it) {
+        if (!lookup_.emplace(*it, index).second) {
+          for (auto added = argument->names_.begin(); added != it; ++added)
+            lookup_.erase(*added);
+          throw SpecException("Argument '" + *it + "' is already defined");
+        }
+      }
+    }
+    ++*revision_;
+    argument->layout_   = layout_.get();
+    argument->index_    = index;
+    argument->offset_   = layout_->add<T>();
+    argument->revision_ = revision_.get();
+    Argument<T> &res  = *argument;
+    arguments_.push_back(std::move(argument));
+    return res;
+  }
+
+  Result parse_args(int argc, const char *const *argv,
+                    std::pmr::memory_resource *resource =
+                        std::pmr::get_default_resource()) const {
+    return try_parse_args(argc, argv, resource).value();
+  }
+
+  Expected<Result>
+  try_parse_args(int argc, const char *const *argv,
+                 std::pmr::memory_resource *resource =
+                     std::pmr::get_default_resource()) const {
+    Expected<TypedResult> values = try_parse_typed(argc, argv, resource);
+    if (!values)
+      return values.error();
+    Result result(resource);
+#ifdef ARGPARSE_INSTRUMENTATION
+    detail::Span span(observer_, Event::collect, program_name_, {}, 0,
+                      resource);
+#endif
+    collect(*values, result);
+    return Expected<Result>(std::move(result));
+  }
+
+  ArgumentParser &freeze() {
+    compile();
+    for (auto &it : subcommands_)
+      it.get().freeze();
     return *this;
   }
-  Argument<T> &required(bool required = true) override {
-    is_required_ = required;
-    return *this;
+
+  TypedResult parse_typed(int argc, const char *const *argv,
+                          std::pmr::memory_resource *resource =
+                              std::pmr::get_default_resource()) const {
+    return try_parse_typed(argc, argv, resource).value();
+  }
+
+  Expected<TypedResult>
+  try_parse_typed(int argc, const char *const *argv,
+                  std::pmr::memory_resource *resource =
+                      std::pmr::get_default_resource()) const {
+#ifdef ARGPARSE_INSTRUMENTATION
+    detail::Span span(observer_, Event::parse, program_name_, {},
+                      argc > 1 ? static_cast<std::size_t>(argc - 1) : 0,
+                      resource);
+#endif
+    compile();
+    TypedResult values(layout_, resource);
+    ParseError error;
+    ParseState state(*this, values, error,
+                     argc > 0 ? static_cast<std::size_t>(argc) : 0);
+    bool ok = true;
+    for (int i = 1; ok && i < argc; ++i)
+      ok = feed(state, argv[i]);
+    if (!ok || !finish(state)) {
+      if (argc > 1)
+        locate(error, argv + 1, argv + argc, 1);
+      return error;
+    }
+    return Expected<TypedResult>(std::move(values));
+  }
+
+  template <typename Tokens>
+  void parse(const Tokens &tokens, TypedResult &values) const {
+    if (ParseError error = try_parse(tokens, values))
+      error.raise();
+  }
+
+  template <typename Tokens>
+  void parse(const Tokens &tokens, Result &result) const {
+    if (ParseError error = try_parse(tokens, result))
+      error.raise();
+  }
+
+  template <typename Tokens>
+  ParseError try_parse(const Tokens &tokens, TypedResult &values) const {
+#ifdef ARGPARSE_INSTRUMENTATION
+    detail::Span span(observer_, Event::parse, program_name_, {},
+                      std::size(tokens), values.resource());
+#endif
+    compile();
+    if (values.layout_ != layout_ ||
+        values.present_.size() != layout_->slots.size())
+      values = TypedResult(layout_, values.resource());
+    else
+      values.clear();
+    ParseError error;
+    ParseState state(*this, values, error, std::size(tokens));
+    bool ok = true;
+    for (auto it = std::begin(tokens); ok && it != std::end(tokens); ++it)
+      ok = feed(state, *it);
+    if (!ok || !finish(state))
+      locate(error, std::begin(tokens), std::end(tokens), 0);
+    return error;
+  }
+
+  template <typename Tokens>
+  ParseError try_parse(const Tokens &tokens, Result &result) const {
+    if (!result.scratch_)
+      result.scratch_ = detail::make_resource_ptr<TypedResult>(
+          result.resource(), result.resource());
+    result.clear();
+    if (ParseError error = try_parse(tokens, *result.scratch_))
+      return error;
+#ifdef ARGPARSE_INSTRUMENTATION
+    detail::Span span(observer_, Event::collect, program_name_, {}, 0,
+                      result.resource());
+#endif
+    collect(*result.scratch_, result);
+    return {};
+  }
+
+  const std::string &usage() const {
+    render();
+    return usage_;
+  }
+  const std::string &help() const {
+    render();
+    return help_;
+  }
+
+  void print_usage(std::ostream &os) const { write(os, usage()); }
+  void print_usage(std::FILE *stream) const { write(stream, usage()); }
+  void print_help(std::ostream &os) const { write(os, help()); }
+  void print_help(std::FILE *stream) const { write(stream, help()); }
+
+protected:
+  bool short_usage_, response_files_;
+  std::string program_name_;
+  std::string short_, description_, epilog_;
+
+  std::vector<std::unique_ptr<ArgumentBase>> arguments_;
+  struct Subcommand {
+    std::string name, help;
+    std::function<void(ArgumentParser &)> builder;
+    mutable std::shared_ptr<ArgumentParser> parser;
+#ifdef ARGPARSE_INSTRUMENTATION
+    Observer *observer = nullptr;
+#endif
+
+    ArgumentParser &get() const {
+      if (!parser) {
+        auto built = std::make_shared<ArgumentParser>(name);
+        built->short_description(help);
+#ifdef ARGPARSE_INSTRUMENTATION
+        built->observer_ = observer;
+#endif
+        if (builder)
+          builder(*built);
+        parser = std::move(built);
+      }
+      return *parser;
+    }
+    const std::string &summary() const {
+      return parser ? parser->short_ : help;
+    }
+  };
+
+  std::vector<Subcommand> subcommands_;
+  struct Rule {
+    std::string group;
+    bool exclusive, required;
+  };
+  std::vector<Rule> rules_;
+  struct Config {
+    std::mutex mutex;
+    std::string path;
+    std::unique_ptr<const detail::ConfigFile> file;
+  };
+  std::unique_ptr<Config> config_;
+
+  struct Table {
+    enum Flags : std::uint8_t {
+      is_positional = 1,
+      is_required   = 2,
+      has_default   = 4,
+      is_streamed   = 8,
+      is_parallel   = 16,
+      has_fallback  = 32
+    };
+    struct Group {
+      std::string_view name;
+      std::size_t first, words;
+      bool exclusive, required;
+    };
+
+    std::vector<const ArgumentBase *> arguments;
+    std::vector<std::string_view> names;
+    std::vector<std::int8_t> nargs;
+    std::vector<std::uint8_t> flags;
+    std::vector<std::uint32_t> positional;
+    std::vector<std::uint32_t> constrained;
+    std::vector<Group> groups;
+    std::vector<std::uint64_t> masks;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> dependencies;
+    std::size_t stream_from;
+
+    std::size_t min_values(std::size_t index) const {
+      if (nargs[index] > 0)
+        return static_cast<std::size_t>(nargs[index]);
+      return nargs[index] == -2 ||
+                     (nargs[index] == 0 && (flags[index] & is_positional))
+                 ? 1
+                 : 0;
+    }
+  };
+
+  std::unordered_map<std::string_view, std::uint32_t> lookup_;
+  std::shared_ptr<detail::Layout> layout_;
+  mutable Table table_;
+  mutable std::vector<const ArgumentBase *> sorted_arguments_;
+  mutable std::vector<const Subcommand *> sorted_subcommands_;
+  mutable detail::NameTrie trie_;
+  mutable std::size_t compiled_;
+  std::size_t width_;
+  std::unique_ptr<std::size_t> revision_;
+  mutable std::size_t rendered_;
+  mutable std::string usage_, help_;
+#ifdef ARGPARSE_INSTRUMENTATION
+  Observer *observer_ = nullptr;
+#endif
+
+private:
+  struct ParseState {
+    ParseState(const ArgumentParser &owner, TypedResult &out,
+               ParseError &failure, std::size_t capacity)
+        : parser(owner), values(out), error(failure), positional(out.tokens_),
+          deferred(out.resource()), runs(out.resource()),
+          active(detail::NameTrie::npos), taken(0), streamed(0),
+          options_done(false) {
+      positional.clear();
+      positional.reserve(capacity);
+    }
+
+    const ArgumentParser &parser;
+    TypedResult &values;
+    ParseError &error;
+    std::pmr::vector<std::string_view> &positional;
+    std::pmr::vector<std::string_view> deferred;
+    std::pmr::vector<std::pair<std::uint32_t, std::size_t>> runs;
+    std::uint32_t active;
+    std::size_t taken, streamed;
+    bool options_done;
+    detail::resource_ptr<ParseState> subcommand;
+
+    struct Expansion {
+      std::vector<detail::MappedFile> files;
+      std::vector<std::size_t> open;
+      detail::StringArena escaped;
+      std::string scratch;
+    };
+    std::unique_ptr<Expansion> expansion;
+  };
+
+  bool feed(ParseState &state, std::string_view token) const {
+    if (response_files_ && token.size() > 1 && token[0] == '@') {
+      const ParseState *leaf = &state;
+      while (leaf->subcommand)
+        leaf = leaf->subcommand.get();
+      if (!leaf->options_done)
+        return expand(state, token.substr(1));
+    }
+
+    if (state.subcommand)
+      return state.subcommand->parser.feed(*state.subcommand, token);
+
+    if (!state.options_done && token.size() > 1 && token[0] == '-') {
+      if (token == "--") {
+        state.options_done = true;
+        return close(state);
+      }
+
+      std::string_view name = token;
+      std::size_t eq        = std::string_view::npos;
+      if (token[1] == '-' && (eq = token.find('=')) != std::string_view::npos)
+        name = token.substr(0, eq);
+
+      const auto match = trie_.find(name, token[1] == '-' && name.size() > 2);
+      if (match.ambiguous)
+        return fail(state, ErrorCode::ambiguous_argument, name);
+      if (match.value != detail::NameTrie::npos) {
+        if (!close(state))
+          return false;
+        open(state, match.value);
+        if (eq != std::string_view::npos)
+          return take(state, token.substr(eq + 1));
+        else if (table_.nargs[match.value] == 0)
+          return close(state);
+        return true;
+      } else if (token[1] != '-' &&
+                 trie_.find(token.substr(0, 2), false).value !=
+                     detail::NameTrie::npos) {
+        return cluster(state, token);
+      } else if (!detail::is_negative_number(token)) {
+        return fail(state, ErrorCode::unrecognized_argument, token);
+      }
+    }
+
+    if (state.active != detail::NameTrie::npos)
+      return take(state, token);
+
+    if (!state.options_done && !subcommands_.empty()) {
+      if (const Subcommand *entry = find_subcommand(token)) {
+        const ArgumentParser &subcommand = entry->get();
+        subcommand.compile();
+        std::pmr::memory_resource *resource = state.values.resource();
+        state.values.subcommand_ = detail::make_resource_ptr<TypedResult>(
+            resource, subcommand.layout_, resource);
+        state.subcommand = detail::make_resource_ptr<ParseState>(
+            resource, subcommand, *state.values.subcommand_, state.error,
+            state.positional.capacity());
+        return true;
+      }
+    }
+
+    if (state.positional.size() == table_.stream_from) {
+      ++state.streamed;
+      return convert(state, table_.positional.back(), &token, 1);
+    }
+    state.positional.push_back(token);
+    return true;
+  }
+
+  bool expand(ParseState &state, std::string_view path) const {
+#ifdef ARGPARSE_INSTRUMENTATION
+    detail::Span span(observer_, Event::tokenize, program_name_, path);
+#endif
+    if (!state.expansion)
+      state.expansion = std::make_unique<ParseState::Expansion>();
+    ParseState::Expansion &expansion = *state.expansion;
+    const std::size_t index          = expansion.files.size();
+    try {
+      expansion.files.emplace_back(std::string{path});
+    } catch (const ParseException &error) {
+      return fail(state, ErrorCode::response_file, error.what(), path);
+    }
+    for (const std::size_t open : expansion.open)
+      if (expansion.files[open].same(expansion.files[index]))
+        return fail(state, ErrorCode::recursive_response_file, path);
+    expansion.open.push_back(index);
+
+    const std::string_view text = expansion.files[index].view();
+    const char *it = text.data(), *const end = text.data() + text.size();
+    while (true) {
+      while (it != end && detail::is_shell_space(*it))
+        ++it;
+      if (it == end)
+        break;
+      expansion.scratch.clear();
+      std::string_view token;
+      try {
+        token = detail::next_shell_token(it, end, expansion.scratch);
+      } catch (const ParseException &error) {
+        return fail(state, ErrorCode::response_file, error.what(), path);
+      }
+      if (token.data() == expansion.scratch.data())
+        token = expansion.escaped.store(token);
+      if (!feed(state, token))
+        return false;
+    }
+    expansion.open.pop_back();
+    return true;
+  }
+
+  static bool fail(ParseState &state, ErrorCode code, std::string_view text,
+                   std::string_view token = {},
+                   const ArgumentBase *argument = nullptr,
+                   std::size_t offset = 0) {
+    ParseError &error = state.error;
+    error.code_       = code;
+    error.offset_     = offset;
+    error.argument_   = argument;
+    error.token_      = token.data() != nullptr ? token.data() : text.data();
+    error.text_.assign(text.data(), text.size());
+    return false;
   }
-  Argument<T> &optional(bool optional = true) override {
-    is_required_ = !optional;
-    return *this;
+
+  template <typename Iterator>
+  static void locate(ParseError &error, Iterator first, Iterator last,
+                     std::size_t index) {
+    const std::less<const char *> less;
+    for (; error.token_ != nullptr && first != last; ++first, ++index) {
+      const std::string_view token(*first);
+      if (!less(error.token_, token.data()) &&
+          !less(token.data() + token.size(), error.token_)) {
+        error.index_ = index;
+        return;
+      }
+    }
   }
 
-  template <typename U>
-  typename std::enable_if<std::is_convertible<U, T>::value, Argument<T>>::type &
-  default_value(const U &value) {
-    default_ = static_cast<T>(value);
-    return *this;
+  bool cluster(ParseState &state, std::string_view token) const {
+    for (std::size_t i = 1; i < token.size(); ++i) {
+      const char name[2]        = {'-', token[i]};
+      const std::uint32_t index = trie_.find({name, 2}, false).value;
+      if (index == detail::NameTrie::npos)
+        return fail(state, ErrorCode::unrecognized_argument, token, token,
+                    nullptr, i);
+
+      if (!close(state))
+        return false;
+      open(state, index);
+      if (table_.nargs[index] == 0) {
+        if (!close(state))
+          return false;
+      } else {
+        std::string_view value = token.substr(i + 1);
+        if (!value.empty() && value[0] == '=')
+          value.remove_prefix(1);
+        return value.empty() || take(state, value);
+      }
+    }
+    return true;
   }
 
-  template <typename U>
-  typename std::enable_if<std::is_convertible<U, T>::value, Argument<T>>::type &
-  implicit_value(const U &value) {
-    implicit_ = static_cast<T>(value);
-    return *this;
+  void compile() const {
+    const std::size_t stamp = revision();
+    if (stamp == compiled_)
+      return;
+#ifdef ARGPARSE_INSTRUMENTATION
+    detail::Span span(observer_, Event::compile, program_name_, {},
+                      arguments_.size());
+#endif
+    std::vector<std::pair<std::string_view, std::uint32_t>> names;
+    names.reserve(lookup_.size());
+    for (const auto &it : lookup_)
+      names.emplace_back(it.first, it.second);
+    trie_.build(std::move(names));
+
+    table_.arguments.clear();
+    table_.names.clear();
+    table_.nargs.clear();
+    table_.flags.clear();
+    table_.positional.clear();
+    table_.constrained.clear();
+    table_.arguments.reserve(arguments_.size());
+    table_.names.reserve(arguments_.size());
+    table_.nargs.reserve(arguments_.size());
+    table_.flags.reserve(arguments_.size());
+    for (const auto &it : arguments_) {
+      std::uint8_t flags = 0;
+      if (it->is_positional_) {
+        flags |= Table::is_positional;
+        table_.positional.push_back(static_cast<std::uint32_t>(it->index_));
+      }
+      if (it->is_required_)
+        flags |= Table::is_required;
+      if (it->has_default())
+        flags |= Table::has_default;
+      if (it->has_sink())
+        flags |= Table::is_streamed;
+      if (it->is_parallel())
+        flags |= Table::is_parallel;
+      if (!it->env_.empty() || !it->config_.empty())
+        flags |= Table::has_fallback;
+      if (it->has_constraints())
+        table_.constrained.push_back(static_cast<std::uint32_t>(it->index_));
+      table_.arguments.push_back(it.get());
+      table_.names.push_back(it->names_.back());
+      table_.nargs.push_back(it->nargs_);
+      table_.flags.push_back(flags);
+    }
+
+    table_.stream_from = std::numeric_limits<std::size_t>::max();
+    if (!table_.positional.empty() &&
+        (table_.flags[table_.positional.back()] & Table::is_streamed) &&
+        table_.nargs[table_.positional.back()] < -1) {
+      std::size_t prefix = 0;
+      for (std::size_t i = 0; i + 1 < table_.positional.size(); ++i) {
+        if (table_.nargs[table_.positional[i]] < 0) {
+          prefix = std::numeric_limits<std::size_t>::max();
+          break;
+        }
+        prefix += table_.min_values(table_.positional[i]);
+      }
+      table_.stream_from = prefix;
+    }
+
+    compile_rules();
+
+    sorted_subcommands_.clear();
+    sorted_subcommands_.reserve(subcommands_.size());
+    for (const auto &it : subcommands_)
+      sorted_subcommands_.push_back(&it);
+    std::sort(sorted_subcommands_.begin(), sorted_subcommands_.end(),
+              [](const Subcommand *lhs, const Subcommand *rhs) {
+                return lhs->name != rhs->name ? lhs->name < rhs->name
+                                              : lhs < rhs;
+              });
+    compiled_ = stamp;
   }
 
-  std::string get_help() const override {
-    std::string res = description_;
-    if constexpr (std::is_same<T, bool>::value) {
-      if (nargs_ != 0) {
-        res += " [" + std::string{detail::nameof<bool>()};
-        if (default_.has_value())
-          res += "=" + detail::to_string(default_.value());
-        if (implicit_.has_value())
-          res += "(=" + detail::to_string(implicit_.value()) + ")";
-        res += "]";
+  void compile_rules() const {
+    table_.groups.clear();
+    table_.masks.clear();
+    table_.dependencies.clear();
+    for (const Rule &rule : rules_) {
+      std::size_t first = arguments_.size(), last = 0;
+      for (const auto &it : arguments_) {
+        if (it->group_ == rule.group) {
+          first = std::min(first, it->index_);
+          last  = it->index_;
+        }
+      }
+      if (first > last)
+        throw SpecException("Argument group '" + rule.group +
+                            "' has no arguments");
+      const std::size_t offset = table_.masks.size();
+      table_.groups.push_back({rule.group, first / 64,
+                               last / 64 - first / 64 + 1, rule.exclusive,
+                               rule.required});
+      table_.masks.resize(offset + table_.groups.back().words, 0);
+      for (const auto &it : arguments_)
+        if (it->group_ == rule.group)
+          table_.masks[offset + it->index_ / 64 - first / 64] |=
+              std::uint64_t{1} << (it->index_ % 64);
+    }
+
+    for (const auto &it : arguments_) {
+      for (const auto &name : it->depends_) {
+        auto match = lookup_.find(name);
+        std::uint32_t index =
+            match != lookup_.end() ? match->second : detail::NameTrie::npos;
+        for (const auto &other : arguments_)
+          if (index == detail::NameTrie::npos && other->is_positional_ &&
+              other->names_.back() == name)
+            index = static_cast<std::uint32_t>(other->index_);
+        if (index == detail::NameTrie::npos)
+          throw SpecException("Argument '" + it->names_.back() +
+                              "' depends on undefined argument '" + name +
+                              "'");
+        table_.dependencies.emplace_back(
+            static_cast<std::uint32_t>(it->index_), index);
       }
-    } else {
-      res += " [" + std::string{detail::nameof<T>()};
-      if (default_.has_value())
-        res += "=" + detail::to_string(default_.value());
-      if (implicit_.has_value())
-        res += "(=" + detail::to_string(implicit_.value()) + ")";
-      res += "]";
     }
-    return res;
   }
 
-protected:
-  std::optional<T> default_, implicit_;
-};
+  bool fallback(ParseState &state, std::uint32_t index, bool &found) const {
+    const ArgumentBase &argument = *table_.arguments[index];
+    if (!argument.env_.empty()) {
+      if (const char *value = std::getenv(argument.env_.c_str())) {
+        const std::string_view token(value);
+        found                       = true;
+        state.values.counts_[index] = 1;
+        return convert(state, index, &token, 1);
+      }
+    }
+    if (argument.config_.empty() || !config_)
+      return true;
 
-class ArgumentParser {
-public:
-  ArgumentParser(std::string program_name = {})
-      : short_usage_(false), program_name_{std::move(program_name)} {}
+    const detail::ConfigFile *file = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(config_->mutex);
+      if (!config_->file) {
+        try {
+          config_->file =
+              std::make_unique<const detail::ConfigFile>(config_->path);
+        } catch (const ParseException &error) {
+          fail(state, ErrorCode::config_file, error.what());
+          state.error.token_ = nullptr;
+          return false;
+        }
+      }
+      file = config_->file.get();
+    }
+    std::size_t count              = 0;
+    const std::string_view *tokens = file->find(argument.config_, count);
+    if (tokens == nullptr || count == 0)
+      return true;
+    found                       = true;
+    state.values.counts_[index] = 1;
+    return convert(state, index, tokens, count);
+  }
 
-  ArgumentParser(ArgumentParser &&) noexcept = default;
-  ArgumentParser &operator=(ArgumentParser &&) = default;
+  bool validate(ParseState &state) const {
+    const auto reject = [&state](ErrorCode code, std::string_view text,
+                                 const ArgumentBase *argument) {
+      fail(state, code, text, {}, argument);
+      state.error.token_ = nullptr;
+      return false;
+    };
 
-  ArgumentParser &description(std::string description) {
-    description_ = std::move(description);
-    return *this;
+    const std::pmr::vector<std::uint8_t> &counts = state.values.counts_;
+    for (const std::uint32_t index : table_.constrained) {
+      if (counts[index] == 0)
+        continue;
+      std::string text;
+      const ErrorCode code = table_.arguments[index]->check(state.values, text);
+      if (code != ErrorCode::none)
+        return reject(code, text, table_.arguments[index]);
+    }
+
+    const std::uint64_t *mask = table_.masks.data();
+    for (const Table::Group &group : table_.groups) {
+      std::uint32_t given = detail::NameTrie::npos;
+      for (std::size_t word = 0; word < group.words; ++word) {
+        for (std::uint64_t bits = mask[word]; bits != 0; bits &= bits - 1) {
+          const std::size_t index =
+              (group.first + word) * 64 + detail::countr_zero(bits);
+          if (counts[index] == 0)
+            continue;
+          if (given != detail::NameTrie::npos && group.exclusive)
+            return reject(ErrorCode::mutually_exclusive, table_.names[given],
+                          table_.arguments[index]);
+          given = static_cast<std::uint32_t>(index);
+        }
+      }
+      if (given == detail::NameTrie::npos && group.required)
+        return reject(ErrorCode::missing_group, group.name, nullptr);
+      mask += group.words;
+    }
+
+    for (const auto &dependency : table_.dependencies)
+      if (counts[dependency.first] != 0 && counts[dependency.second] == 0)
+        return reject(ErrorCode::missing_dependency,
+                      table_.names[dependency.second],
+                      table_.arguments[dependency.first]);
+    return true;
   }
-  ArgumentParser &short_description(std::string short_description) {
-    short_ = std::move(short_description);
-    return *this;
+
+  void open(ParseState &state, std::uint32_t index) const {
+    std::uint8_t &count = state.values.counts_[index];
+    if (count != std::numeric_limits<std::uint8_t>::max())
+      ++count;
+    state.active = index;
+    state.taken  = 0;
   }
-  ArgumentParser &epilog(std::string epilog) {
-    epilog_ = std::move(epilog);
-    return *this;
+
+  bool take(ParseState &state, std::string_view token) const {
+    const std::uint32_t index = state.active;
+    const std::int8_t nargs   = table_.nargs[index];
+    ++state.taken;
+    if (nargs == 0 || nargs == -1 ||
+        (nargs > 0 && state.taken == static_cast<std::size_t>(nargs)))
+      state.active = detail::NameTrie::npos;
+    if (table_.flags[index] & Table::is_parallel) {
+      if (state.runs.empty())
+        state.deferred.reserve(state.positional.capacity());
+      if (state.runs.empty() || state.runs.back().first != index)
+        state.runs.emplace_back(index, state.deferred.size());
+      state.deferred.push_back(token);
+      return true;
+    }
+    return convert(state, index, &token, 1);
   }
 
-  ArgumentParser &add_subcommand(const std::string &name,
-                                 const std::string &help) {
-    std::shared_ptr<ArgumentParser> subcommand =
-        std::make_shared<ArgumentParser>(name);
-    subcommand->short_description(help);
-    subcommands_.push_back(subcommand);
-    sort_subcommands();
-    return *subcommand;
+  bool convert(ParseState &state, std::uint32_t index,
+               const std::string_view *tokens, std::size_t count) const {
+#ifdef ARGPARSE_INSTRUMENTATION
+    detail::Span span(observer_, Event::convert, program_name_,
+                      table_.names[index], count);
+#endif
+    std::string_view failed;
+    if (count == 1 ? table_.arguments[index]->store_value(state.values,
+                                                          *tokens, failed)
+                   : table_.arguments[index]->store_values(
+                         state.values, tokens, count, failed))
+      return true;
+    return fail(state, ErrorCode::invalid_value, failed, failed,
+                table_.arguments[index]);
   }
 
-  template <typename T = bool, typename... Args>
-  Argument<T> &add_argument(Args... args) {
-    using array_of_sv = std::string_view[sizeof...(Args)];
-    std::shared_ptr<Argument<T>> argument =
-        std::make_shared<Argument<T>>(array_of_sv{args...});
-    arguments_.push_back(std::static_pointer_cast<ArgumentBase>(argument));
-    sort_arguments();
-    if (argument->is_positional_) {
-      positional_.push_back(std::static_pointer_cast<ArgumentBase>(argument));
+  bool close(ParseState &state) const {
+    if (state.active == detail::NameTrie::npos)
+      return true;
+    const std::uint32_t index = state.active;
+    state.active              = detail::NameTrie::npos;
+    if (state.taken != 0)
+      return true;
+    else if (table_.nargs[index] > 0 || table_.nargs[index] == -2)
+      return fail(state, ErrorCode::missing_value, {}, {},
+                  table_.arguments[index]);
+    table_.arguments[index]->store_implicit(state.values);
+    return true;
+  }
+
+  bool finish(ParseState &state) const {
+#ifdef ARGPARSE_INSTRUMENTATION
+    detail::Span span(observer_, Event::validate, program_name_);
+#endif
+    if (!close(state))
+      return false;
+
+    for (std::size_t i = 0; i < state.runs.size(); ++i) {
+      const std::size_t first = state.runs[i].second;
+      const std::size_t last  = i + 1 < state.runs.size()
+                                    ? state.runs[i + 1].second
+                                    : state.deferred.size();
+      if (!convert(state, state.runs[i].first, state.deferred.data() + first,
+                   last - first))
+        return false;
     }
-    return *argument;
+
+    std::size_t minimum = 0;
+    for (const std::uint32_t index : table_.positional)
+      minimum += table_.min_values(index);
+
+    std::size_t pos = 0;
+    for (const std::uint32_t index : table_.positional) {
+      if (state.streamed != 0 && index == table_.positional.back()) {
+        state.values.counts_[index] = 1;
+        break;
+      }
+      const std::size_t required = table_.min_values(index);
+      minimum -= required;
+      const std::size_t available =
+          state.positional.size() - pos > minimum
+              ? state.positional.size() - pos - minimum
+              : 0;
+      std::size_t consume = required;
+      if (table_.nargs[index] == -1)
+        consume = std::min<std::size_t>(available, 1);
+      else if (table_.nargs[index] < -1)
+        consume = std::max(available, required);
+      if (pos + consume > state.positional.size())
+        break;
+      if (!convert(state, index, state.positional.data() + pos, consume))
+        return false;
+      pos += consume;
+      if (consume != 0)
+        state.values.counts_[index] = 1;
+    }
+    if (pos < state.positional.size())
+      return fail(state, ErrorCode::unrecognized_argument,
+                  state.positional[pos]);
+
+    for (std::size_t i = 0; i < table_.flags.size(); ++i) {
+      if (state.values.present_[i])
+        continue;
+      if (table_.flags[i] & Table::has_fallback) {
+        bool found = false;
+        if (!fallback(state, static_cast<std::uint32_t>(i), found))
+          return false;
+        if (found)
+          continue;
+      }
+      if (table_.flags[i] & Table::has_default)
+        table_.arguments[i]->store_default(state.values);
+      else if (table_.flags[i] & Table::is_required)
+        return fail(state, ErrorCode::missing_argument, {}, {},
+                    table_.arguments[i]);
+    }
+
+    if ((!table_.constrained.empty() || !table_.groups.empty() ||
+         !table_.dependencies.empty()) &&
+        !validate(state))
+      return false;
+    return !state.subcommand ||
+           state.subcommand->parser.finish(*state.subcommand);
+  }
+
+  std::size_t revision() const {
+    std::size_t stamp = *revision_;
+    for (const auto &it : subcommands_)
+      if (it.parser)
+        stamp += *it.parser->revision_;
+    return stamp;
+  }
+
+  void render() const {
+    const std::size_t stamp = revision();
+    if (stamp == rendered_)
+      return;
+#ifdef ARGPARSE_INSTRUMENTATION
+    detail::Span span(observer_, Event::help, program_name_, {},
+                      arguments_.size());
+#endif
+    compile();
+    const std::size_t width = width_ != 0 ? width_ : detail::terminal_width();
+    sorted_arguments_.assign(table_.arguments.begin(), table_.arguments.end());
+    std::sort(sorted_arguments_.begin(), sorted_arguments_.end(),
+              [](const ArgumentBase *lhs, const ArgumentBase *rhs) {
+                return lhs->names_.back() != rhs->names_.back()
+                           ? lhs->names_.back() < rhs->names_.back()
+                           : lhs->index_ < rhs->index_;
+              });
+    usage_.clear();
+    help_.clear();
+    render_usage(usage_, width);
+    render_help(help_, width);
+    rendered_ = stamp;
   }
 
-  std::string usage() const {
-    std::string usage_msg = "Usage: " + program_name_;
+  void render_usage(std::string &out, std::size_t width) const {
+    std::string line = "Usage: " + program_name_;
 
     if (short_usage_) {
       if (!arguments_.empty())
-        usage_msg += " [options]";
-
-      for (auto &it : positional_)
-        usage_msg += " " + it->get_usage();
+        line += " [options]";
     } else {
-      for (auto &it : arguments_)
-        if (!it->is_positional_)
-          usage_msg += " " + it->get_usage();
-      for (auto &it : positional_)
-        usage_msg += " " + it->get_usage();
+      for (const auto &it : sorted_arguments_) {
+        if (it->is_positional_)
+          continue;
+        line += ' ';
+        it->write_usage(line);
+      }
+    }
+    for (const std::uint32_t index : table_.positional) {
+      line += ' ';
+      table_.arguments[index]->write_usage(line);
     }
 
     if (!subcommands_.empty())
-      usage_msg += " [subcommand...]";
+      line += " [subcommand...]";
 
-    return detail::wrap(usage_msg,
-                        8 + static_cast<std::uint8_t>(program_name_.length()));
+    out.reserve(line.size() + line.size() / 8);
+    detail::append_wrapped(
+        out, line, 8 + detail::display_width(program_name_), 0, width);
   }
 
-  std::string help() const {
-    std::string help_msg = usage() + "\n\n";
+  void render_help(std::string &out, std::size_t width) const {
+    std::size_t longest_cmd = 0, longest_key = 0, capacity = usage_.size();
+    for (const auto &it : sorted_subcommands_) {
+      longest_cmd = std::max(longest_cmd, detail::display_width(it->name));
+      capacity += it->name.size() + it->summary().size();
+    }
+    for (const auto &it : sorted_arguments_) {
+      longest_key = std::max(longest_key, it->help_key_length());
+      capacity += it->description_.size();
+    }
+    capacity += short_.size() + description_.size() + epilog_.size() +
+                (longest_cmd + 8) * sorted_subcommands_.size() +
+                (longest_key + 32) * sorted_arguments_.size() + 64;
+    out.reserve(capacity);
 
-    if (!short_.empty())
-      help_msg += detail::wrap(short_) + "\n\n";
+    out += usage_;
+    out += "\n\n";
 
+    if (!short_.empty())
+      detail::append_wrapped(out, short_, 0, 0, width) += "\n\n";
     if (!description_.empty())
-      help_msg += detail::wrap(description_) + "\n\n";
+      detail::append_wrapped(out, description_, 0, 0, width) += "\n\n";
 
     if (!subcommands_.empty()) {
-      help_msg += "Subcommands:\n";
-
-      std::uint8_t longest_cmd = 0;
-      for (auto &it : subcommands_)
-        longest_cmd = std::max(
-            longest_cmd, static_cast<std::uint8_t>(it->program_name_.size()));
-
-      for (auto &it : subcommands_)
-        help_msg +=
-            "  " + detail::pad_right(it->program_name_, longest_cmd) + "  " +
-            detail::wrap(it->short_, longest_cmd + 4, longest_cmd + 4) + "\n";
-
-      help_msg += "\n";
+      const std::size_t indent = longest_cmd + 4;
+      out += "Subcommands:\n";
+      for (const auto &it : sorted_subcommands_) {
+        out += "  ";
+        detail::append_padded(out, it->name, longest_cmd);
+        out += "  ";
+        detail::append_wrapped(out, it->summary(), indent, indent, width) +=
+            '\n';
+      }
+      out += '\n';
     }
 
     if (!arguments_.empty()) {
-      std::set<std::string> groups;
-      for (const auto &it : arguments_)
-        if (!it->group_.empty())
-          groups.insert(it->group_);
-
-      std::uint8_t longest_key = 0;
-      for (const auto &it : arguments_)
-        longest_key = std::max(
-            longest_key, static_cast<std::uint8_t>(it->get_help_key().size()));
-
-      if (std::any_of(arguments_.begin(), arguments_.end(), [](const auto &v) {
-            return v->group_.empty() && !v->description_.empty();
-          })) {
-        help_msg += "Options:\n";
-        for (const auto &it : arguments_) {
-          if (!it->group_.empty() || it->description_.empty())
-            continue;
-          help_msg +=
-              "  " + detail::pad_right(it->get_help_key(), longest_key) + "  " +
-              detail::wrap(it->get_help(), longest_key + 4, longest_key + 4) +
-              "\n";
-        }
-        help_msg += "\n";
-      }
+      std::vector<std::string_view> groups;
+      for (const auto &it : sorted_arguments_)
+        groups.push_back(it->group_);
+      std::sort(groups.begin(), groups.end());
+      groups.erase(std::unique(groups.begin(), groups.end()), groups.end());
 
+      const std::size_t indent = longest_key + 4;
+      std::string text;
       for (const auto &group : groups) {
-        if (std::any_of(arguments_.begin(), arguments_.end(),
-                        [group](const auto &v) {
-                          return v->group_ == group && !v->description_.empty();
-                        })) {
-          help_msg += group + ":\n";
-          for (const auto &it : arguments_) {
-            if (it->group_ != group || it->description_.empty())
-              continue;
-            help_msg +=
-                "  " + detail::pad_right(it->get_help_key(), longest_key) +
-                "  " +
-                detail::wrap(it->get_help(), longest_key + 4, longest_key + 4) +
-                "\n";
+        bool header = false;
+        for (const auto &it : sorted_arguments_) {
+          if (it->group_ != group || it->description_.empty())
+            continue;
+          if (!header) {
+            out += group.empty() ? std::string_view{"Options"} : group;
+            out += ":\n";
+            header = true;
           }
-          help_msg += "\n";
+          out += "  ";
+          it->write_help_key(out);
+          out.append(longest_key + 2 - it->help_key_length(), ' ');
+          text.clear();
+          it->write_help(text);
+          detail::append_wrapped(out, text, indent, indent, width) += '\n';
         }
+        if (header)
+          out += '\n';
       }
     }
 
     if (!epilog_.empty())
-      help_msg += detail::wrap(epilog_) + "\n\n";
-    help_msg.pop_back();
-    return help_msg;
+      detail::append_wrapped(out, epilog_, 0, 0, width) += "\n\n";
+    out.pop_back();
   }
 
-protected:
-  bool short_usage_;
-  std::string program_name_;
-  std::string short_, description_, epilog_;
+  static void write(std::ostream &os, const std::string &text) {
+    os.write(text.data(), static_cast<std::streamsize>(text.size()));
+  }
+  static void write(std::FILE *stream, const std::string &text) {
+    std::fwrite(text.data(), 1, text.size(), stream);
+  }
 
-  std::vector<std::shared_ptr<ArgumentBase>> arguments_;
-  std::vector<std::shared_ptr<ArgumentBase>> positional_;
-  std::vector<std::shared_ptr<ArgumentParser>> subcommands_;
+  const Subcommand *find_subcommand(std::string_view name) const {
+    auto it = std::lower_bound(
+        sorted_subcommands_.begin(), sorted_subcommands_.end(), name,
+        [](const Subcommand *lhs, std::string_view rhs) {
+          return lhs->name < rhs;
+        });
+    if (it == sorted_subcommands_.end() || (*it)->name != name)
+      return nullptr;
+    return *it;
+  }
 
-private:
-  void sort_subcommands() {
-    if (!std::is_sorted(subcommands_.begin(), subcommands_.end(),
-                        [](const std::shared_ptr<ArgumentParser> &lhs,
-                           const std::shared_ptr<ArgumentParser> &rhs) {
-                          return lhs->program_name_ < rhs->program_name_;
-                        })) {
-      std::sort(subcommands_.begin(), subcommands_.end(),
-                [](const std::shared_ptr<ArgumentParser> &lhs,
-                   const std::shared_ptr<ArgumentParser> &rhs) {
-                  return lhs->program_name_ < rhs->program_name_;
-                });
+  void collect(TypedResult &values, Result &result) const {
+    const std::size_t base = result.values_.size();
+    result.segments_.push_back({layout_.get(), base, values.present_.size()});
+    result.values_.resize(base + values.present_.size(),
+                          Value{std::any{}, 0});
+    for (const auto &arg : arguments_) {
+      if (!values.present_[arg->index_])
+        continue;
+      const detail::Layout::Slot &slot = layout_->slots[arg->index_];
+      result.values_[base + arg->index_] =
+          Value{slot.release(values.data() + slot.offset),
+                values.counts_[arg->index_]};
+      auto it = result.index_.find(arg->key());
+      if (it != result.index_.end())
+        it->second = base + arg->index_;
+      else
+        result.index_.emplace(result.keys_.store(arg->key()),
+                              base + arg->index_);
+    }
+
+    if (values.subcommand_) {
+      const ArgumentParser &subcommand =
+          find_subcommand(values.subcommand_->command())->get();
+      result.assign(subcommand.program_name_, Value{true, 1});
+      subcommand.collect(*values.subcommand_, result);
     }
   }
+};
+
+namespace detail {
+template <typename T> struct member_pointer;
+template <typename S, typename T> struct member_pointer<T S::*> {
+  using object_type = S;
+  using value_type  = T;
+};
+
+template <std::size_t N> class static_string {
+public:
+  constexpr static_string() : data_{}, size_(0) {}
+
+  constexpr void append(std::string_view text) {
+    for (char c : text)
+      data_[size_++] = c;
+  }
+  constexpr void append_upper(std::string_view text) {
+    for (char c : text)
+      data_[size_++] = c >= 'a' && c <= 'z' ? static_cast<char>(c - 'a' + 'A')
+                                            : c;
+  }
+
+  constexpr std::string_view view() const { return {data_, size_}; }
+  constexpr operator std::string_view() const { return view(); }
+
+private:
+  char data_[N + 1];
+  std::size_t size_;
+};
+
+template <typename T>
+inline constexpr bool is_list_v =
+    is_container<T>::value && !std::is_same<T, std::string>::value;
+} // namespace detail
+
+template <auto Member, std::size_t... L> class Field {
+public:
+  using object_type =
+      typename detail::member_pointer<decltype(Member)>::object_type;
+  using value_type =
+      typename detail::member_pointer<decltype(Member)>::value_type;
+
+  static constexpr std::size_t name_count = sizeof...(L);
+  static constexpr std::size_t usage_capacity =
+      2 * std::max({std::size_t{0}, L...}) + 16;
+
+  constexpr explicit Field(const char (&...names)[L])
+      : names_{std::string_view{names, L - 1}...}, help_{},
+        required_(!names_[0].empty() && names_[0][0] != '-') {}
+
+  constexpr Field help(std::string_view help) const {
+    Field copy = *this;
+    copy.help_ = help;
+    return copy;
+  }
+  constexpr Field required(bool required = true) const {
+    Field copy     = *this;
+    copy.required_ = required;
+    return copy;
+  }
+
+  constexpr std::size_t size() const { return name_count; }
+  constexpr std::string_view name(std::size_t i) const { return names_[i]; }
+  constexpr std::string_view help() const { return help_; }
+  constexpr bool is_required() const { return required_; }
+  constexpr bool is_positional() const {
+    return !names_[0].empty() && names_[0][0] != '-';
+  }
+
+  constexpr std::string_view longest() const {
+    std::string_view res = names_[0];
+    for (std::string_view name : names_)
+      if (name.size() > res.size() || (name.size() == res.size() && res < name))
+        res = name;
+    return res;
+  }
+
+  constexpr std::int8_t nargs() const {
+    if constexpr (std::is_same<value_type, bool>::value)
+      return is_positional() ? 1 : 0;
+    else if constexpr (detail::is_list_v<value_type>)
+      return required_ ? -2 : -3;
+    else
+      return 1;
+  }
+
+  constexpr std::size_t min_values() const {
+    const std::int8_t n = nargs();
+    return n == 1 || n == -2 ? 1 : 0;
+  }
+
+  constexpr detail::static_string<usage_capacity> usage() const {
+    detail::static_string<usage_capacity> res;
+    std::string_view meta = longest();
+    while (!meta.empty() && meta[0] == '-')
+      meta.remove_prefix(1);
 
-  void sort_arguments() {
-    if (!std::is_sorted(arguments_.begin(), arguments_.end(),
-                        [](const std::shared_ptr<ArgumentBase> &lhs,
-                           const std::shared_ptr<ArgumentBase> &rhs) {
-                          return lhs->names_.back() < rhs->names_.back();
-                        })) {
-      std::sort(arguments_.begin(), arguments_.end(),
-                [](const std::shared_ptr<ArgumentBase> &lhs,
-                   const std::shared_ptr<ArgumentBase> &rhs) {
-                  return lhs->names_.back() < rhs->names_.back();
-                });
+    if (!required_)
+      res.append("[");
+    if (!is_positional())
+      res.append(longest());
+    const std::string_view sep = is_positional() ? "" : " ";
+    switch (nargs()) {
+    case 1:
+      res.append(sep);
+      res.append_upper(meta);
+      break;
+    case -2:
+      res.append(sep);
+      res.append_upper(meta);
+      res.append(" [");
+      res.append_upper(meta);
+      res.append(" ...]");
+      break;
+    case -3:
+      res.append(sep);
+      res.append("[");
+      res.append_upper(meta);
+      res.append(" [");
+      res.append_upper(meta);
+      res.append(" ...]]");
+      break;
+    default:
+      break;
     }
+    if (!required_)
+      res.append("]");
+    return res;
+  }
+
+  void set(object_type &object) const {
+    if constexpr (std::is_same<value_type, bool>::value)
+      object.*Member = true;
+  }
+  void store(object_type &object, std::string_view token) const {
+    parse(token, object.*Member);
   }
+
+private:
+  std::string_view names_[sizeof...(L)];
+  std::string_view help_;
+  bool required_;
 };
 
-template <typename T,
-          typename std::enable_if<std::is_integral<T>::value>::type * = nullptr>
-inline void parse(const std::string &text, T &value) {
+template <auto Member, std::size_t... L>
+constexpr Field<Member, L...> field(const char (&...names)[L]) {
+  return Field<Member, L...>{names...};
+}
 
-  using US = typename std::make_unsigned<T>::type;
+template <typename S, std::size_t N, typename... Fields> class StaticParser {
+  static_assert(sizeof...(Fields) > 0, "A parser requires at least one field.");
+  static_assert((std::is_same<S, typename Fields::object_type>::value && ...),
+                "Every field must be a member of the parsed structure.");
 
-  std::smatch match;
-  std::regex_match(text, match, detail::integer_pattern);
-  if (match.length() == 0)
-    throw argument_incorrect_type{text, detail::nameof<T>()};
-
-  const bool negative = match[1].length() > 0;
-
-  std::uint8_t base = 10;
-  if (match[2] == "0x" || match[2] == "0X")
-    base = 16;
-  else if (match[2] == "0")
-    base = 8;
-  else if (match[2] == "0b")
-    base = 2;
-
-  const std::string &val = match[3];
-
-  US result = 0;
-  for (char ch : val) {
-    US digit = 0;
-    if (base == 2) {
-      if (ch == '0' || ch == '1')
-        digit = static_cast<US>(ch - '0');
-      else
-        throw argument_incorrect_type{text, detail::nameof<T>()};
-    } else if (base == 8) {
-      if (ch >= '0' && ch <= '7')
-        digit = static_cast<US>(ch - '0');
-      else
-        throw argument_incorrect_type{text, detail::nameof<T>()};
-    } else if (base == 10) {
-      if (ch >= '0' && ch <= '9')
-        digit = static_cast<US>(ch - '0');
-      else
-        throw argument_incorrect_type{text, detail::nameof<T>()};
-    } else if (base == 16) {
-      if (ch >= '0' && ch <= '9')
-        digit = static_cast<US>(ch - '0');
-      else if (ch >= 'a' && ch <= 'f')
-        digit = static_cast<US>(ch - 'a' + 10);
-      else if (ch >= 'A' && ch <= 'F')
-        digit = static_cast<US>(ch - 'A' + 10);
+public:
+  static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+  static constexpr std::size_t usage_capacity =
+      7 + N + ((Fields::usage_capacity + 1) + ... + 0);
+
+  constexpr StaticParser(const char (&program_name)[N], Fields... fields)
+      : program_name_{program_name, N - 1}, fields_{fields...}, table_{},
+        options_{}, option_count_(0), positional_{}, positional_count_(0) {
+    index(std::index_sequence_for<Fields...>{});
+
+    for (std::size_t i = 1; i < table_.size(); ++i)
+      for (std::size_t j = i; j > 0 && table_[j].name < table_[j - 1].name; --j)
+        swap(table_[j], table_[j - 1]);
+    for (std::size_t i = 1; i < option_count_; ++i)
+      for (std::size_t j = i;
+           j > 0 && longest(options_[j]) < longest(options_[j - 1]); --j) {
+        const std::size_t tmp = options_[j];
+        options_[j]           = options_[j - 1];
+        options_[j - 1]       = tmp;
+      }
+  }
+
+  constexpr std::string_view program_name() const { return program_name_; }
+
+  constexpr std::size_t find(std::string_view name) const {
+    std::size_t lo = 0, hi = table_.size();
+    while (lo < hi) {
+      const std::size_t mid = lo + (hi - lo) / 2;
+      if (table_[mid].name < name)
+        lo = mid + 1;
       else
-        throw argument_incorrect_type{text, detail::nameof<T>()};
-    } else {
-      throw argument_incorrect_type{text, detail::nameof<T>()};
+        hi = mid;
     }
+    return lo < table_.size() && table_[lo].name == name ? table_[lo].field
+                                                         : npos;
+  }
 
-    const US next = static_cast<US>(result * base + digit);
-    if (result > next)
-      throw argument_incorrect_type{text, detail::nameof<T>()};
-    else if ((std::numeric_limits<US>::max() - digit) / base < result)
-      throw argument_incorrect_type{text, detail::nameof<T>()};
-    result = next;
+  constexpr detail::static_string<usage_capacity> usage() const {
+    detail::static_string<usage_capacity> res;
+    res.append("Usage: ");
+    res.append(program_name_);
+    for (std::size_t i = 0; i < option_count_; ++i)
+      append_usage(res, options_[i], std::index_sequence_for<Fields...>{});
+    for (std::size_t i = 0; i < positional_count_; ++i)
+      append_usage(res, positional_[i], std::index_sequence_for<Fields...>{});
+    return res;
   }
 
-  if constexpr (std::numeric_limits<T>::is_signed) {
-    if (negative) {
-      if (result > static_cast<US>(std::numeric_limits<T>::min()))
-        throw argument_incorrect_type{text, detail::nameof<T>()};
-    } else {
-      if (result > static_cast<US>(std::numeric_limits<T>::max()))
-        throw argument_incorrect_type{text, detail::nameof<T>()};
+  S parse_args(int argc, const char *const *argv) const {
+    S result{};
+    std::bitset<sizeof...(Fields)> seen;
+    std::vector<std::string_view> positional;
+    positional.reserve(argc > 0 ? static_cast<std::size_t>(argc) : 0);
+
+    std::size_t active = npos, taken = 0;
+    bool options_done = false;
+    const auto close  = [&]() {
+      if (active != npos && taken == 0 && min_values(active) != 0)
+        throw ParseException("Argument '" + std::string{longest(active)} +
+                             "' expected a value");
+      active = npos;
+    };
+
+    for (int i = 1; i < argc; ++i) {
+      const std::string_view token = argv[i];
+      if (!options_done && token.size() > 1 && token[0] == '-') {
+        if (token == "--") {
+          close();
+          options_done = true;
+          continue;
+        }
+
+        std::string_view name = token;
+        std::size_t eq        = std::string_view::npos;
+        if (token[1] == '-' &&
+            (eq = token.find('=')) != std::string_view::npos)
+          name = token.substr(0, eq);
+
+        const std::size_t field = find(name);
+        if (field != npos && !is_positional(field)) {
+          close();
+          seen.set(field);
+          if (eq != std::string_view::npos) {
+            visit(field, [&](const auto &f) {
+              f.store(result, token.substr(eq + 1));
+            });
+          } else if (min_values(field) == 0 && nargs(field) == 0) {
+            visit(field, [&](const auto &f) { f.set(result); });
+          } else {
+            active = field;
+            taken  = 0;
+          }
+          continue;
+        } else if (!detail::is_negative_number(token)) {
+          throw ParseException("Unrecognized argument '" +
+                               std::string{token} + "'");
+        }
+      }
+
+      if (active != npos) {
+        visit(active, [&](const auto &f) { f.store(result, token); });
+        ++taken;
+        if (nargs(active) == 1)
+          active = npos;
+        continue;
+      }
+      positional.push_back(token);
     }
-  }
+    close();
 
-  if (negative) {
-    if constexpr (std::numeric_limits<T>::is_signed) {
-      value = static_cast<T>(-static_cast<T>(result - 1) - 1);
-    } else {
-      throw argument_incorrect_type{text, detail::nameof<T>()};
+    std::size_t minimum = 0;
+    for (std::size_t i = 0; i < positional_count_; ++i)
+      minimum += min_values(positional_[i]);
+
+    std::size_t pos = 0;
+    for (std::size_t i = 0; i < positional_count_; ++i) {
+      const std::size_t field    = positional_[i];
+      const std::size_t required = min_values(field);
+      minimum -= required;
+      const std::size_t available = positional.size() - pos > minimum
+                                        ? positional.size() - pos - minimum
+                                        : 0;
+      const std::size_t consume =
+          nargs(field) < 0 ? std::max(available, required) : required;
+      if (pos + consume > positional.size())
+        break;
+      for (std::size_t j = 0; j < consume; ++j)
+        visit(field,
+              [&](const auto &f) { f.store(result, positional[pos++]); });
+      if (consume != 0)
+        seen.set(field);
     }
-  } else {
-    value = static_cast<T>(result);
+    if (pos < positional.size())
+      throw ParseException("Unrecognized argument '" +
+                           std::string{positional[pos]} + "'");
+
+    for (std::size_t i = 0; i < sizeof...(Fields); ++i)
+      if (!seen.test(i) && is_required(i))
+        throw ParseException("Argument '" + std::string{longest(i)} +
+                             "' is required");
+    return result;
   }
-}
 
-inline void parse(const std::string &text, bool &value) {
-  std::smatch result;
-  std::regex_match(text, result, detail::truthy_pattern);
-  if (!result.empty()) {
-    value = true;
-  } else {
-    std::regex_match(text, result, detail::falsy_pattern);
-    if (!result.empty()) {
-      value = false;
-    } else {
-      throw argument_incorrect_type{text, detail::nameof<bool>()};
-    }
+private:
+  struct Entry {
+    std::string_view name;
+    std::size_t field;
+  };
+
+  static constexpr void swap(Entry &lhs, Entry &rhs) {
+    const Entry tmp = lhs;
+    lhs             = rhs;
+    rhs             = tmp;
   }
-}
 
-inline void parse(const std::string &text, std::string &value) { value = text; }
+  template <std::size_t... I>
+  constexpr void index(std::index_sequence<I...>) {
+    std::size_t n = 0;
+    (index(std::get<I>(fields_), I, n), ...);
+  }
+  template <typename F>
+  constexpr void index(const F &f, std::size_t field, std::size_t &n) {
+    for (std::size_t i = 0; i < f.size(); ++i)
+      table_[n++] = {f.name(i), field};
+    if (f.is_positional())
+      positional_[positional_count_++] = field;
+    else
+      options_[option_count_++] = field;
+  }
 
-inline void parse(const std::string &text, char &c) {
-  if (text.length() != 1)
-    throw argument_incorrect_type{text, detail::nameof<char>()};
-  c = text[0];
-}
+  template <typename F> void visit(std::size_t field, F &&f) const {
+    visit(field, f, std::index_sequence_for<Fields...>{});
+  }
+  template <typename F, std::size_t... I>
+  void visit(std::size_t field, F &f, std::index_sequence<I...>) const {
+    (void)((field == I ? (f(std::get<I>(fields_)), true) : false) || ...);
+  }
 
-template <typename T, typename std::enable_if<!std::is_integral<T>::value>::type
-                          * = nullptr>
-inline void parse(const std::string &text, T &value) {
-  std::stringstream in(text);
-  in >> value;
-  if (!in) {
-    throw argument_incorrect_type{text, detail::nameof<T>()};
+  template <std::size_t... I>
+  constexpr void append_usage(detail::static_string<usage_capacity> &res,
+                              std::size_t field,
+                              std::index_sequence<I...>) const {
+    (void)((field == I
+                ? (res.append(" "), res.append(std::get<I>(fields_).usage()),
+                   true)
+                : false) ||
+           ...);
   }
-}
 
-template <typename T>
-inline void parse(const std::string &text, std::vector<T> &value) {
-  if (!text.empty()) {
-    std::stringstream in(text);
-    std::string token;
-    while (!in.eof() && std::getline(in, token, ',')) {
-      T v;
-      parse(token, v);
-      value.emplace_back(std::move(v));
-    }
+  template <typename F> constexpr auto get(std::size_t field, F f) const {
+    return get(field, f, std::index_sequence_for<Fields...>{});
+  }
+  template <typename F, std::size_t... I>
+  constexpr auto get(std::size_t field, F f, std::index_sequence<I...>) const {
+    decltype(f(std::get<0>(fields_))) res{};
+    (void)((field == I ? (res = f(std::get<I>(fields_)), true) : false) ||
+           ...);
+    return res;
   }
-}
 
-template <typename T>
-inline void parse(const std::string &text, std::optional<T> &value) {
-  if (!text.empty()) {
-    T result;
-    parse(text, result);
-    value = std::move(result);
+  constexpr std::string_view longest(std::size_t field) const {
+    return get(field, [](const auto &f) { return f.longest(); });
+  }
+  constexpr std::int8_t nargs(std::size_t field) const {
+    return get(field, [](const auto &f) { return f.nargs(); });
+  }
+  constexpr std::size_t min_values(std::size_t field) const {
+    return get(field, [](const auto &f) { return f.min_values(); });
+  }
+  constexpr bool is_positional(std::size_t field) const {
+    return get(field, [](const auto &f) { return f.is_positional(); });
+  }
+  constexpr bool is_required(std::size_t field) const {
+    return get(field, [](const auto &f) { return f.is_required(); });
   }
-}
 
-template <typename T> inline T parse(const std::string &text) {
-  T res{};
-  parse(text, res);
-  return res;
+  std::string_view program_name_;
+  std::tuple<Fields...> fields_;
+  std::array<Entry, (Fields::name_count + ... + 0)> table_;
+  std::array<std::size_t, sizeof...(Fields)> options_;
+  std::size_t option_count_;
+  std::array<std::size_t, sizeof...(Fields)> positional_;
+  std::size_t positional_count_;
+};
+
+template <typename S, std::size_t N, typename... Fields>
+constexpr StaticParser<S, N, Fields...> make_parser(const char (&program_name)[N],
+                                                    Fields... fields) {
+  return StaticParser<S, N, Fields...>{program_name, fields...};
 }
 
 } // namespace argparse
@@ -0,0 +1,897 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_vector.hpp>
+
+#include <argparse/argparse.hpp>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace argparse;
+using namespace Catch;
+using namespace Catch::Matchers;
+
+namespace {
+void set_env(const char *name, const char *value) {
+#if defined(_WIN32)
+  _putenv_s(name, value == nullptr ? "" : value);
+#else
+  if (value == nullptr)
+    unsetenv(name);
+  else
+    setenv(name, value, 1);
+#endif
+}
+} // namespace
+
+TEST_CASE("parse arguments") {
+  ArgumentParser parser("test");
+  parser.add_argument("-v", "--verbose").help("verbose output");
+  parser.add_argument<int>("-j", "--jobs").default_value(1);
+  parser.add_argument<std::string>("-o", "--output");
+  parser.add_argument<std::vector<int>>("ints");
+
+  SECTION("options and positionals") {
+    const char *argv[] = {"test", "-v", "--jobs", "4", "1", "2", "3"};
+    Result res         = parser.parse_args(7, argv);
+    CHECK(res.get<bool>("verbose"));
+    CHECK(res.get<int>("jobs") == 4);
+    CHECK(res.count("jobs") == 1);
+    CHECK_FALSE(res.has("output"));
+    CHECK_THAT(res.get<std::vector<int>>("ints"),
+               Equals(std::vector<int>{1, 2, 3}));
+  }
+
+  SECTION("defaults and inline values") {
+    const char *argv[] = {"test", "--output=out.txt", "--", "-1"};
+    Result res         = parser.parse_args(4, argv);
+    CHECK_FALSE(res.get<bool>("verbose"));
+    CHECK(res.get<int>("jobs") == 1);
+    CHECK(res.count("jobs") == 0);
+    CHECK(res.get<std::string>("output") == "out.txt");
+    CHECK_THAT(res.get<std::vector<int>>("ints"),
+               Equals(std::vector<int>{-1}));
+  }
+
+  SECTION("negative numbers and repeated flags") {
+    const char *argv[] = {"test", "-j", "-2", "-v", "-v", "-5"};
+    Result res         = parser.parse_args(6, argv);
+    CHECK(res.get<int>("jobs") == -2);
+    CHECK(res.count("verbose") == 2);
+    CHECK_THAT(res.get<std::vector<int>>("ints"),
+               Equals(std::vector<int>{-5}));
+  }
+
+  SECTION("errors") {
+    const char *unknown[] = {"test", "--unknown", "1"};
+    CHECK_THROWS_AS(parser.parse_args(3, unknown), ParseException);
+    const char *missing[] = {"test", "-v"};
+    CHECK_THROWS_AS(parser.parse_args(2, missing), ParseException);
+    const char *value[] = {"test", "1", "--jobs"};
+    CHECK_THROWS_AS(parser.parse_args(3, value), ParseException);
+    const char *type[] = {"test", "a"};
+    CHECK_THROWS_AS(parser.parse_args(2, type), argument_incorrect_type);
+  }
+
+  SECTION("duplicate names") {
+    CHECK_THROWS_AS(parser.add_argument("--verbose"), SpecException);
+    CHECK_THROWS_AS(parser.add_argument("-q", "--quiet", "--output"),
+                    SpecException);
+    CHECK_THROWS_AS(parser.add_argument("-d", "-d"), SpecException);
+    parser.add_argument("-q", "--quiet");
+
+    const char *argv[] = {"test", "-q", "-o", "out.txt", "1"};
+    Result res         = parser.parse_args(5, argv);
+    CHECK(res.get<bool>("quiet"));
+    CHECK(res.get<std::string>("output") == "out.txt");
+    CHECK_THROWS_AS(res.get<bool>("d"), std::out_of_range);
+  }
+}
+
+TEST_CASE("parse positional arguments") {
+  ArgumentParser parser("test");
+  parser.add_argument<std::vector<std::string>>("inputs");
+  parser.add_argument<std::string>("output");
+
+  const char *argv[] = {"test", "a", "b", "c"};
+  Result res         = parser.parse_args(4, argv);
+  CHECK_THAT(res.get<std::vector<std::string>>("inputs"),
+             Equals(std::vector<std::string>{"a", "b"}));
+  CHECK(res.get<std::string>("output") == "c");
+}
+
+TEST_CASE("parse subcommands") {
+  ArgumentParser parser("test");
+  parser.add_argument("-v", "--verbose");
+  parser.add_subcommand("build", "build the project")
+      .add_argument<int>("-j", "--jobs");
+  parser.add_subcommand("clean", "clean the project");
+
+  const char *argv[] = {"test", "-v", "build", "--jobs", "8"};
+  Result res         = parser.parse_args(5, argv);
+  CHECK(res.get<bool>("verbose"));
+  CHECK(res.has("build"));
+  CHECK_FALSE(res.has("clean"));
+  CHECK(res.get<int>("jobs") == 8);
+}
+
+TEST_CASE("parse list delimiters") {
+  ArgumentParser parser("test");
+  parser.add_argument<std::vector<int>>("--ids").delimiters(":");
+
+  const char *argv[] = {"test", "--ids", "1:2", "3"};
+  Result res         = parser.parse_args(4, argv);
+  CHECK_THAT(res.get<std::vector<int>>("ids"),
+             Equals(std::vector<int>{1, 2, 3}));
+}
+
+TEST_CASE("parse abbreviations and clusters") {
+  ArgumentParser parser("test");
+  parser.add_argument("-x", "--extract");
+  parser.add_argument("-v", "--verbose");
+  parser.add_argument("--version");
+  parser.add_argument<std::string>("-f", "--file");
+  parser.add_argument<int>("-j", "--jobs");
+  parser.freeze();
+
+  SECTION("unique prefixes") {
+    const char *argv[] = {"test", "--verb", "--ext", "--fi=a.txt"};
+    Result res         = parser.parse_args(4, argv);
+    CHECK(res.get<bool>("verbose"));
+    CHECK(res.get<bool>("extract"));
+    CHECK_FALSE(res.get<bool>("version"));
+    CHECK(res.get<std::string>("file") == "a.txt");
+  }
+
+  SECTION("ambiguous prefixes") {
+    const char *argv[] = {"test", "--ver"};
+    CHECK_THROWS_AS(parser.parse_args(2, argv), ParseException);
+  }
+
+  SECTION("empty long names") {
+    const char *argv[] = {"test", "--=3"};
+    CHECK_THROWS_AS(parser.parse_args(2, argv), ParseException);
+
+    ArgumentParser single("test");
+    single.add_argument<int>("--jobs");
+    CHECK(single.try_parse_args(2, argv).error().code() ==
+          ErrorCode::unrecognized_argument);
+  }
+
+  SECTION("clustered short flags") {
+    const char *argv[] = {"test", "-xvf", "a.txt", "-j4"};
+    Result res         = parser.parse_args(4, argv);
+    CHECK(res.get<bool>("extract"));
+    CHECK(res.get<bool>("verbose"));
+    CHECK(res.get<std::string>("file") == "a.txt");
+    CHECK(res.get<int>("jobs") == 4);
+  }
+
+  SECTION("attached short values") {
+    const char *argv[] = {"test", "-xfa.txt", "-j=-2"};
+    Result res         = parser.parse_args(3, argv);
+    CHECK(res.get<bool>("extract"));
+    CHECK(res.get<std::string>("file") == "a.txt");
+    CHECK(res.get<int>("jobs") == -2);
+  }
+
+  SECTION("unknown cluster members") {
+    const char *argv[] = {"test", "-xq"};
+    CHECK_THROWS_AS(parser.parse_args(2, argv), ParseException);
+  }
+
+  SECTION("arguments added after freezing") {
+    parser.add_argument("--extra");
+    const char *argv[] = {"test", "--extra"};
+    CHECK(parser.parse_args(2, argv).get<bool>("extra"));
+  }
+}
+
+TEST_CASE("usage is sorted after unordered registration") {
+  ArgumentParser parser("test");
+  parser.width(80);
+  parser.add_argument("-z", "--zebra");
+  parser.add_argument("-a", "--apple");
+  parser.add_subcommand("stop", "stop the service");
+  parser.add_subcommand("start", "start the service");
+  CHECK(parser.usage() == "Usage: test [--apple] [--zebra] [subcommand...]");
+  const std::string help = parser.help();
+  CHECK(help.find("start") < help.find("stop"));
+
+  parser.add_argument("-m", "--mango");
+  CHECK(parser.usage() ==
+        "Usage: test [--apple] [--mango] [--zebra] [subcommand...]");
+
+  const char *argv[] = {"test", "--mango", "start"};
+  Result res         = parser.parse_args(3, argv);
+  CHECK(res.get<bool>("mango"));
+  CHECK(res.has("start"));
+}
+
+TEST_CASE("help is cached until the parser changes") {
+  ArgumentParser parser("test");
+  parser.width(80).description("Test program");
+  auto &verbose = parser.add_argument("-v", "--verbose").help("verbose output");
+
+  const std::string &help = parser.help();
+  const std::string first = help;
+  CHECK(&parser.help() == &help);
+  CHECK(parser.help().data() == help.data());
+  CHECK(first.find("verbose output") != std::string::npos);
+
+  verbose.help("louder output");
+  CHECK(parser.help().find("louder output") != std::string::npos);
+
+  parser.add_argument<int>("-j", "--jobs").help("job count");
+  CHECK(parser.help().find("-j, --jobs JOBS") != std::string::npos);
+  CHECK(parser.usage() == "Usage: test [--jobs JOBS] [--verbose]");
+
+  std::ostringstream os;
+  parser.print_help(os);
+  CHECK(os.str() == parser.help());
+}
+
+TEST_CASE("standalone arguments can be configured") {
+  Argument<int> jobs({"-j", "--jobs"});
+  jobs.help("job count").group("Build").required().default_value(1);
+  jobs.choices({1, 2, 4}).range(1, 4).env("JOBS").config("jobs");
+  CHECK(jobs.help_key_length() == 15);
+}
+
+TEST_CASE("help wraps to the configured width") {
+  ArgumentParser parser("test");
+  parser.width(30).description("a description that does not fit on one line");
+  CHECK(parser.help() == "Usage: test\n\na description that does not\nfit "
+                         "on one line\n");
+
+  parser.width(200);
+  CHECK(parser.help() ==
+        "Usage: test\n\na description that does not fit on one line\n");
+
+  set_env("COLUMNS", "30");
+  parser.width(0);
+  const std::string wrapped = parser.help();
+  CHECK(wrapped.find("does not\nfit") != std::string::npos);
+  set_env("COLUMNS", "200");
+  CHECK(parser.help() == wrapped);
+  parser.width(0);
+  CHECK(parser.help().find("does not fit") != std::string::npos);
+  set_env("COLUMNS", nullptr);
+}
+
+TEST_CASE("lazy subcommands are built on demand") {
+  int built = 0;
+  ArgumentParser parser("test");
+  parser.width(80);
+  parser.add_argument("-v", "--verbose");
+  for (const char *name : {"build", "clean", "deploy"})
+    parser.add_subcommand(name, std::string{name} + " the project",
+                          [&built](ArgumentParser &sub) {
+                            ++built;
+                            sub.add_argument<int>("-j", "--jobs");
+                          });
+
+  CHECK(parser.help().find("deploy  deploy the project") != std::string::npos);
+  CHECK(built == 0);
+
+  const char *argv[] = {"test", "-v", "clean", "--jobs", "4"};
+  Result res         = parser.parse_args(5, argv);
+  CHECK(built == 1);
+  CHECK(res.has("clean"));
+  CHECK(res.get<int>("jobs") == 4);
+
+  res = parser.parse_args(5, argv);
+  CHECK(built == 1);
+
+  CHECK(parser.subcommand("deploy").usage() == "Usage: deploy [--jobs JOBS]");
+  CHECK(built == 2);
+  CHECK_THROWS_AS(parser.subcommand("missing"), std::out_of_range);
+}
+
+TEST_CASE("argument changes after parsing are honoured") {
+  ArgumentParser parser("test");
+  auto &jobs = parser.add_argument<int>("-j", "--jobs");
+
+  const char *argv[] = {"test"};
+  CHECK_FALSE(parser.parse_args(1, argv).has("jobs"));
+
+  jobs.default_value(2);
+  CHECK(parser.parse_args(1, argv).get<int>("jobs") == 2);
+
+  parser.add_argument<std::string>("-o", "--output").required();
+  CHECK_THROWS_AS(parser.parse_args(1, argv), ParseException);
+}
+
+TEST_CASE("parse reuses a caller provided result") {
+  ArgumentParser parser("test");
+  ArgHandle<int> jobs = parser.add_argument<int>("-j", "--jobs");
+  parser.add_argument("-v", "--verbose");
+  ArgHandle<std::string> target =
+      parser.add_subcommand("build", "build the project")
+          .add_argument<std::string>("target");
+  parser.add_subcommand("clean", "clean the project")
+      .add_argument("-f", "--force");
+  parser.freeze();
+
+  SECTION("results") {
+    Result res;
+    const std::vector<std::string_view> build = {"-j", "4", "build", "all"};
+    parser.parse(build, res);
+    CHECK(res.get(jobs) == 4);
+    CHECK(res.get<std::string>("target") == "all");
+    CHECK(res.has("build"));
+
+    const std::string_view clean[] = {"-v", "clean", "--force"};
+    parser.parse(clean, res);
+    CHECK_FALSE(res.has("jobs"));
+    CHECK_FALSE(res.has("build"));
+    CHECK_FALSE(res.has("target"));
+    CHECK_FALSE(res.has(target));
+    CHECK(res.get<bool>("verbose"));
+    CHECK(res.get<bool>("force"));
+
+    const std::string_view invalid[] = {"--jobs"};
+    CHECK_THROWS_AS(parser.parse(invalid, res), ParseException);
+    CHECK_FALSE(res.has("verbose"));
+
+    Result copy = res;
+    parser.parse(build, res);
+    CHECK_FALSE(copy.has("jobs"));
+    CHECK(res.get(jobs) == 4);
+  }
+
+  SECTION("typed results") {
+    TypedResult res;
+    CHECK(res.command().empty());
+    const std::vector<std::string> tokens = {"--jobs=2", "build", "lib"};
+    parser.parse(tokens, res);
+    CHECK(res.command() == "test");
+    CHECK(res.get(jobs) == 2);
+    CHECK(res.get(target) == "lib");
+
+    parser.parse(std::vector<std::string_view>{"clean"}, res);
+    CHECK_FALSE(res.has(jobs));
+    CHECK_FALSE(res.has(target));
+    REQUIRE(res.subcommand() != nullptr);
+    CHECK(res.subcommand()->command() == "clean");
+  }
+
+  SECTION("arguments added between parses") {
+    TypedResult res;
+    parser.parse(std::vector<std::string_view>{"-j", "1"}, res);
+    ArgHandle<int> level = parser.add_argument<int>("--level");
+    parser.parse(std::vector<std::string_view>{"--level", "3"}, res);
+    CHECK(res.get(level) == 3);
+    CHECK_FALSE(res.has(jobs));
+  }
+}
+
+TEST_CASE("frozen parsers are shared between threads") {
+  ArgumentParser parser("test");
+  ArgHandle<int> id = parser.add_argument<int>("--id");
+  ArgHandle<std::vector<int>> ids =
+      parser.add_subcommand("batch", "batch request")
+          .add_argument<std::vector<int>>("ids");
+  parser.freeze();
+
+  std::vector<int> failures(4, 0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t] {
+      TypedResult res;
+      for (int i = 0; i < 1000; ++i) {
+        const std::string value = std::to_string(t * 1000 + i);
+        const std::string_view tokens[] = {"--id", value, "batch", value, "7"};
+        parser.parse(tokens, res);
+        if (res.get(id) != t * 1000 + i ||
+            res.get(ids) != std::vector<int>{t * 1000 + i, 7})
+          ++failures[static_cast<std::size_t>(t)];
+      }
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+  CHECK(failures == std::vector<int>(4, 0));
+}
+
+TEST_CASE("response files expand in place") {
+  const auto dir = std::filesystem::temp_directory_path();
+  const std::string outer = (dir / "argparse-outer.rsp").string();
+  const std::string inner = (dir / "argparse-inner.rsp").string();
+  const std::string cycle = (dir / "argparse-cycle.rsp").string();
+  std::ofstream(outer) << "--jobs 4\n'a b.txt' @" << inner << " d.txt\n";
+  std::ofstream(inner) << "# \"c\\\".txt\"\n";
+  std::ofstream(cycle) << "a.txt @" << outer << " @" << cycle;
+
+  ArgumentParser parser("test");
+  parser.add_argument<int>("-j", "--jobs");
+  parser.add_argument<std::vector<std::string>>("files");
+
+  SECTION("disabled by default") {
+    const std::string arg = "@" + outer;
+    const char *argv[]    = {"test", arg.c_str()};
+    Result res            = parser.parse_args(2, argv);
+    CHECK_THAT(res.get<std::vector<std::string>>("files"),
+               Equals(std::vector<std::string>{arg}));
+  }
+
+  parser.response_files();
+
+  SECTION("nested files") {
+    const std::string arg = "@" + outer;
+    const char *argv[]    = {"test", "first", arg.c_str(), "last"};
+    Result res            = parser.parse_args(4, argv);
+    CHECK(res.get<int>("jobs") == 4);
+    CHECK_THAT(res.get<std::vector<std::string>>("files"),
+               Equals(std::vector<std::string>{"first", "a b.txt", "#",
+                                               "c\".txt", "d.txt", "last"}));
+  }
+
+  SECTION("the same file twice") {
+    const std::string arg = "@" + inner;
+    const char *argv[]    = {"test", arg.c_str(), arg.c_str()};
+    CHECK(parser.parse_args(3, argv).get<std::vector<std::string>>("files") ==
+          std::vector<std::string>{"#", "c\".txt", "#", "c\".txt"});
+  }
+
+  SECTION("after the end of options") {
+    const std::string arg = "@" + outer;
+    const char *argv[]    = {"test", "--", arg.c_str()};
+    Result res            = parser.parse_args(3, argv);
+    CHECK_THAT(res.get<std::vector<std::string>>("files"),
+               Equals(std::vector<std::string>{arg}));
+  }
+
+  SECTION("errors") {
+    const std::string arg = "@" + cycle;
+    const char *argv[]    = {"test", arg.c_str()};
+    CHECK_THROWS_AS(parser.parse_args(2, argv), ParseException);
+    const char *missing[] = {"test", "@/nonexistent/argparse.rsp"};
+    CHECK_THROWS_AS(parser.parse_args(2, missing), ParseException);
+    CHECK(parser.try_parse_args(2, argv).error().code() ==
+          ErrorCode::recursive_response_file);
+    const ParseError error = parser.try_parse_args(2, missing).error();
+    CHECK(error.code() == ErrorCode::response_file);
+    CHECK(error.index() == 1);
+    CHECK(error.message().find("argparse.rsp") != std::string::npos);
+  }
+
+  std::filesystem::remove(outer);
+  std::filesystem::remove(inner);
+  std::filesystem::remove(cycle);
+}
+
+TEST_CASE("list arguments stream into sinks") {
+  std::vector<std::string> inputs;
+  std::vector<int> ids;
+  ArgumentParser parser("test");
+  parser.add_argument<std::string>("command");
+  auto &files = parser.add_argument<std::vector<std::string>>("inputs").sink(
+      [&inputs](std::string value) { inputs.push_back(std::move(value)); });
+  parser.add_argument<std::vector<int>>("--ids").sink(
+      [&ids](int value) { ids.push_back(value); });
+  parser.add_argument<int>("-j", "--jobs").required();
+
+  SECTION("values reach the sink as they are parsed") {
+    const char *argv[] = {"test", "copy", "a", "--ids", "1,2", "3",
+                          "-j",   "2",    "b", "c"};
+    Result res         = parser.parse_args(10, argv);
+    CHECK_THAT(inputs, Equals(std::vector<std::string>{"a", "b", "c"}));
+    CHECK_THAT(ids, Equals(std::vector<int>{1, 2, 3}));
+    CHECK(res.get<std::string>("command") == "copy");
+    CHECK(res.get<std::vector<std::string>>("inputs").empty());
+    CHECK(res.count("inputs") == 1);
+    CHECK(res.get<std::vector<int>>("ids").empty());
+  }
+
+  SECTION("values are consumed before parsing finishes") {
+    const char *argv[] = {"test", "copy", "a", "b", "--ids", "4", "x"};
+    CHECK_THROWS_AS(parser.parse_args(7, argv), ParseException);
+    CHECK_THAT(inputs, Equals(std::vector<std::string>{"a", "b"}));
+    CHECK_THAT(ids, Equals(std::vector<int>{4}));
+  }
+
+  SECTION("at least one value is still required") {
+    const char *argv[] = {"test", "copy", "-j", "1"};
+    CHECK_THROWS_AS(parser.parse_args(4, argv), ParseException);
+  }
+
+  SECTION("trailing positionals defer the sink") {
+    parser.add_argument<std::string>("output");
+    const char *argv[] = {"test", "copy", "a", "b", "out", "-j", "1"};
+    Result res         = parser.parse_args(7, argv);
+    CHECK_THAT(inputs, Equals(std::vector<std::string>{"a", "b"}));
+    CHECK(res.get<std::string>("output") == "out");
+  }
+
+  SECTION("removing the sink") {
+    files.sink(nullptr);
+    const char *argv[] = {"test", "copy", "a", "-j", "1"};
+    Result res         = parser.parse_args(5, argv);
+    CHECK(inputs.empty());
+    CHECK_THAT(res.get<std::vector<std::string>>("inputs"),
+               Equals(std::vector<std::string>{"a"}));
+  }
+}
+
+TEST_CASE("large lists convert in parallel") {
+  std::vector<std::string> tokens;
+  std::vector<int> expected;
+  for (int i = 0; i < 40000; ++i) {
+    expected.push_back(i * 3);
+    if (i % 10 == 9)
+      tokens.back() += "," + std::to_string(i * 3);
+    else
+      tokens.push_back(std::to_string(i * 3));
+  }
+
+  ArgumentParser parser("test");
+  parser.add_argument<std::vector<int>>("--ids").parallel(4);
+  parser.add_argument<std::vector<double>>("values").parallel(3);
+  parser.add_argument("-v", "--verbose");
+
+  std::vector<const char *> argv = {"test", "--ids"};
+  for (const auto &token : tokens)
+    argv.push_back(token.c_str());
+  argv.push_back("-v");
+  for (const auto &token : tokens)
+    argv.push_back(token.c_str());
+
+  SECTION("values keep their order") {
+    Result res = parser.parse_args(static_cast<int>(argv.size()), argv.data());
+    CHECK(res.get<bool>("verbose"));
+    CHECK(res.get<std::vector<int>>("ids") == expected);
+    const auto values = res.get<std::vector<double>>("values");
+    REQUIRE(values.size() == expected.size());
+    CHECK(values.back() == Approx(119997.0));
+  }
+
+  SECTION("trailing delimiters are dropped") {
+    ArgumentParser small("test");
+    small.add_argument<std::vector<int>>("--ids").parallel(2);
+    const char *trailing[] = {"test", "--ids", "1,2,", "3"};
+    CHECK(small.parse_args(4, trailing).get<std::vector<int>>("ids") ==
+          std::vector<int>{1, 2, 3});
+  }
+
+  SECTION("repeated options are appended") {
+    argv.insert(argv.begin() + 1, {"--ids", "-1,-2", "-v"});
+    Result res = parser.parse_args(static_cast<int>(argv.size()), argv.data());
+    const auto ids = res.get<std::vector<int>>("ids");
+    REQUIRE(ids.size() == expected.size() + 2);
+    CHECK(ids[0] == -1);
+    CHECK(ids[2] == 0);
+  }
+
+  SECTION("the first failing value is reported") {
+    tokens[30000]   = "late";
+    tokens[20000]   = "1,early";
+    argv[2 + 30000] = tokens[30000].c_str();
+    argv[2 + 20000] = tokens[20000].c_str();
+    try {
+      parser.parse_args(static_cast<int>(argv.size()), argv.data());
+      FAIL("expected a conversion error");
+    } catch (const argument_incorrect_type &error) {
+      CHECK(std::string{error.what()}.find("'early'") != std::string::npos);
+    }
+  }
+}
+
+TEST_CASE("parse errors are returned without throwing") {
+  ArgumentParser parser("test");
+  ArgHandle<int> jobs = parser.add_argument<int>("-j", "--jobs");
+  parser.add_argument("-v", "--verbose");
+  parser.add_argument<std::vector<int>>("--ids");
+  parser.add_argument<std::string>("--name");
+  parser.add_argument<std::string>("--names");
+  parser.add_argument<std::string>("input");
+  parser.add_subcommand("build", "build the project")
+      .add_argument<std::string>("target");
+
+  const auto error = [&parser](std::vector<const char *> argv) {
+    argv.insert(argv.begin(), "test");
+    Expected<Result> res =
+        parser.try_parse_args(static_cast<int>(argv.size()), argv.data());
+    CHECK_FALSE(res.has_value());
+    return res.error();
+  };
+
+  SECTION("successful parses hold a value") {
+    const char *argv[]       = {"test", "-j", "4", "in.txt"};
+    Expected<TypedResult> res = parser.try_parse_typed(4, argv);
+    REQUIRE(res);
+    CHECK(res->get(jobs) == 4);
+    CHECK_FALSE(res.error());
+    CHECK(res.error().code() == ErrorCode::none);
+  }
+
+  SECTION("errors carry a code, token index and argument") {
+    ParseError err = error({"in.txt", "--ids", "1,x,3"});
+    CHECK(err.code() == ErrorCode::invalid_value);
+    CHECK(err.index() == 3);
+    CHECK(err.text() == "x");
+    REQUIRE(err.argument() != nullptr);
+    CHECK(err.message().rfind("Argument 'x' failed to parse", 0) == 0);
+
+    err = error({"in.txt", "--nam"});
+    CHECK(err.code() == ErrorCode::ambiguous_argument);
+    CHECK(err.index() == 2);
+    CHECK(err.message() == "Ambiguous argument '--nam'");
+
+    err = error({"in.txt", "--unknown=4"});
+    CHECK(err.code() == ErrorCode::unrecognized_argument);
+    CHECK(err.index() == 2);
+
+    err = error({"-vx", "in.txt"});
+    CHECK(err.code() == ErrorCode::unrecognized_argument);
+    CHECK(err.index() == 1);
+    CHECK(err.message() == "Unrecognized argument '-x' in '-vx'");
+
+    err = error({"in.txt", "extra"});
+    CHECK(err.code() == ErrorCode::unrecognized_argument);
+    CHECK(err.index() == 2);
+
+    err = error({"in.txt", "-j"});
+    CHECK(err.code() == ErrorCode::missing_value);
+    CHECK(err.message() == "Argument '--jobs' expected a value");
+
+    err = error({"-j", "2"});
+    CHECK(err.code() == ErrorCode::missing_argument);
+    CHECK(err.index() == ParseError::npos);
+    CHECK(err.message() == "Argument 'input' is required");
+
+    err = error({"in.txt", "build"});
+    CHECK(err.code() == ErrorCode::missing_argument);
+    CHECK(err.message() == "Argument 'target' is required");
+  }
+
+  SECTION("the throwing API raises the same error") {
+    const char *argv[] = {"test", "-j", "four", "in.txt"};
+    CHECK_THROWS_AS(parser.parse_args(4, argv), argument_incorrect_type);
+    CHECK_THROWS_AS(parser.try_parse_typed(4, argv).value(),
+                    argument_incorrect_type);
+    const char *missing[] = {"test"};
+    CHECK_THROWS_AS(parser.parse_args(1, missing), ParseException);
+  }
+
+  SECTION("re-entrant parses return the error") {
+    Result res;
+    const std::vector<std::string> tokens = {"in.txt", "-j", "x"};
+    const ParseError err                  = parser.try_parse(tokens, res);
+    CHECK(err.code() == ErrorCode::invalid_value);
+    CHECK(err.index() == 2);
+    CHECK_FALSE(parser.try_parse(std::vector<std::string>{"in.txt"}, res));
+    CHECK(res.get<std::string>("input") == "in.txt");
+  }
+}
+
+TEST_CASE("constraints are validated after parsing") {
+  ArgumentParser parser("test");
+  parser.add_argument<std::string>("--mode").choices({"fast", "safe"});
+  parser.add_argument<int>("-l", "--level").range(1, 9).default_value(0);
+  parser.add_argument<std::vector<int>>("--ids").range(0, 99).choices(
+      {1, 2, 3, 42});
+  parser.add_argument("--json").group("Output");
+  parser.add_argument("--yaml").group("Output");
+  parser.add_argument<std::string>("--user").group("Login");
+  parser.add_argument<std::string>("--token").group("Login");
+  parser.add_argument<std::string>("--password").depends_on("--user");
+  parser.mutually_exclusive("Output").required_group("Login");
+
+  const auto parse = [&parser](std::vector<const char *> argv) {
+    argv.insert(argv.begin(), "test");
+    return parser.try_parse_args(static_cast<int>(argv.size()), argv.data());
+  };
+
+  SECTION("valid input") {
+    Expected<Result> res =
+        parse({"--mode", "safe", "-l", "9", "--ids", "1,42", "--user", "me",
+               "--password", "pw", "--json"});
+    REQUIRE(res);
+    CHECK(res->get<int>("level") == 9);
+    CHECK(parse({"--token", "t"}));
+  }
+
+  SECTION("defaults are not checked") {
+    Expected<Result> res = parse({"--token", "t"});
+    REQUIRE(res);
+    CHECK(res->get<int>("level") == 0);
+  }
+
+  SECTION("value constraints") {
+    ParseError err = parse({"--token", "t", "--mode", "slow"}).error();
+    CHECK(err.code() == ErrorCode::invalid_choice);
+    CHECK(err.text() == "slow");
+    CHECK(err.message() ==
+          "Value 'slow' is not a valid choice for argument '--mode'");
+
+    err = parse({"--token", "t", "-l", "10"}).error();
+    CHECK(err.code() == ErrorCode::out_of_range);
+    CHECK(err.message() == "Value '10' is out of range for argument '--level'");
+
+    CHECK(parse({"--token", "t", "--ids", "1,7"}).error().code() ==
+          ErrorCode::invalid_choice);
+    CHECK(parse({"--token", "t", "--ids", "1,420"}).error().code() ==
+          ErrorCode::out_of_range);
+  }
+
+  SECTION("group constraints") {
+    ParseError err = parse({"--token", "t", "--json", "--yaml"}).error();
+    CHECK(err.code() == ErrorCode::mutually_exclusive);
+    CHECK(err.message() == "Argument '--yaml' cannot be used with '--json'");
+
+    err = parse({"--json"}).error();
+    CHECK(err.code() == ErrorCode::missing_group);
+    CHECK(err.message() == "One of the arguments in group 'Login' is required");
+
+    err = parse({"--token", "t", "--password", "pw"}).error();
+    CHECK(err.code() == ErrorCode::missing_dependency);
+    CHECK(err.message() == "Argument '--password' requires '--user'");
+
+    const char *argv[] = {"test", "--json", "--yaml"};
+    CHECK_THROWS_AS(parser.parse_args(3, argv), ParseException);
+  }
+
+  SECTION("groups spanning many arguments") {
+    for (int i = 0; i < 150; ++i)
+      parser.add_argument("--flag-" + std::to_string(i))
+          .group(i % 50 == 0 ? "Wide" : "Other");
+    parser.mutually_exclusive("Wide", true);
+    CHECK(parse({"--token", "t", "--flag-100"}));
+    CHECK(parse({"--token", "t"}).error().code() == ErrorCode::missing_group);
+    CHECK(parse({"--token", "t", "--flag-0", "--flag-100"}).error().code() ==
+          ErrorCode::mutually_exclusive);
+  }
+
+  SECTION("undefined references") {
+    const char *argv[] = {"test", "--token", "t"};
+    auto &extra = parser.add_argument("--extra").depends_on("--missing");
+    CHECK_THROWS_AS(parser.parse_args(3, argv), SpecException);
+    extra.group("Missing");
+    parser.mutually_exclusive("Unused");
+    CHECK_THROWS_AS(parser.parse_args(3, argv), SpecException);
+  }
+}
+
+TEST_CASE("arguments fall back to the environment and config files") {
+  const auto dir         = std::filesystem::temp_directory_path();
+  const std::string ini  = (dir / "argparse-config.ini").string();
+  const std::string json = (dir / "argparse-config.json").string();
+  const std::string bad  = (dir / "argparse-bad.ini").string();
+  std::ofstream(ini) << "# defaults\n"
+                        "name = \"from ini\"\n"
+                        "jobs = 3 ; trailing comment\n"
+                        "\n"
+                        "[build] # build settings\n"
+                        "targets = [ \"a\", 'b c', d ]\n"
+                        "level = 7\r\n";
+  std::ofstream(json) << R"({"name": "from \"json\"", "unset": null,
+    "build": {"targets": ["x", "y"], "level": 2, "verbose": true}})";
+  std::ofstream(bad) << "name = ok\nbroken line\n";
+
+  ArgumentParser parser("test");
+  parser.add_argument<std::string>("--name")
+      .env("ARGPARSE_TEST_NAME")
+      .config("name");
+  parser.add_argument<int>("-j", "--jobs").config("jobs").default_value(1);
+  parser.add_argument<std::vector<std::string>>("--targets")
+      .config("build.targets");
+  parser.add_argument<int>("--level")
+      .env("ARGPARSE_TEST_LEVEL")
+      .config("build.level")
+      .range(0, 9);
+  parser.add_argument("-v", "--verbose").config("build.verbose");
+  parser.add_argument<std::string>("--unset").config("unset");
+  set_env("ARGPARSE_TEST_NAME", nullptr);
+  set_env("ARGPARSE_TEST_LEVEL", nullptr);
+
+  const auto parse = [&parser](std::vector<const char *> argv) {
+    argv.insert(argv.begin(), "test");
+    return parser.try_parse_args(static_cast<int>(argv.size()), argv.data());
+  };
+
+  SECTION("without a config file") {
+    Expected<Result> res = parse({});
+    REQUIRE(res);
+    CHECK(res->get<int>("jobs") == 1);
+    CHECK_FALSE(res->has("name"));
+  }
+
+  SECTION("ini files") {
+    parser.config_file(ini);
+    Expected<Result> res = parse({});
+    REQUIRE(res);
+    CHECK(res->get<std::string>("name") == "from ini");
+    CHECK(res->get<int>("jobs") == 3);
+    CHECK(res->get<int>("level") == 7);
+    CHECK_THAT(res->get<std::vector<std::string>>("targets"),
+               Equals(std::vector<std::string>{"a", "b c", "d"}));
+    CHECK_FALSE(res->get<bool>("verbose"));
+    CHECK_FALSE(res->has("unset"));
+  }
+
+  SECTION("json files") {
+    parser.config_file(json);
+    Expected<Result> res = parse({});
+    REQUIRE(res);
+    CHECK(res->get<std::string>("name") == "from \"json\"");
+    CHECK(res->get<int>("jobs") == 1);
+    CHECK(res->get<int>("level") == 2);
+    CHECK(res->get<bool>("verbose"));
+    CHECK_THAT(res->get<std::vector<std::string>>("targets"),
+               Equals(std::vector<std::string>{"x", "y"}));
+  }
+
+  SECTION("argv overrides env overrides config") {
+    parser.config_file(ini);
+    set_env("ARGPARSE_TEST_NAME", "from env");
+    set_env("ARGPARSE_TEST_LEVEL", "5");
+    Expected<Result> res = parse({"--level", "8"});
+    REQUIRE(res);
+    CHECK(res->get<std::string>("name") == "from env");
+    CHECK(res->get<int>("level") == 8);
+
+    set_env("ARGPARSE_TEST_LEVEL", "12");
+    CHECK(parse({}).error().code() == ErrorCode::out_of_range);
+    set_env("ARGPARSE_TEST_LEVEL", "high");
+    CHECK(parse({}).error().code() == ErrorCode::invalid_value);
+    set_env("ARGPARSE_TEST_NAME", nullptr);
+    set_env("ARGPARSE_TEST_LEVEL", nullptr);
+  }
+
+  SECTION("config files are only read when needed") {
+    parser.config_file((dir / "argparse-missing.ini").string());
+    CHECK(parse({"--name", "n", "-j", "2", "--targets", "t", "--level", "1",
+                 "-v", "--unset", "u"}));
+    const ParseError error = parse({"-j", "2"}).error();
+    CHECK(error.code() == ErrorCode::config_file);
+    CHECK(error.message().find("argparse-missing.ini") != std::string::npos);
+  }
+
+  SECTION("malformed config files") {
+    parser.config_file(bad);
+    const ParseError error = parse({}).error();
+    CHECK(error.code() == ErrorCode::config_file);
+    CHECK(error.message().find("line 2") != std::string::npos);
+    const char *argv[] = {"test"};
+    CHECK_THROWS_AS(parser.parse_args(1, argv), ParseException);
+
+    std::ofstream(bad) << "[build] level = 1\n";
+    parser.config_file(bad);
+    CHECK(parse({}).error().message().find("line 1") != std::string::npos);
+  }
+
+  SECTION("escape sequences") {
+    std::ofstream(json) << R"({"name": "\u0041\u00e9\ud83d\ude00\b\f\/\\",
+      "build": {"targets": ["a\tb", "\"\u65e5\""]}})";
+    parser.config_file(json);
+    Expected<Result> res = parse({});
+    REQUIRE(res);
+    CHECK(res->get<std::string>("name") == "A\u00e9\U0001F600\b\f/\\");
+    CHECK_THAT(res->get<std::vector<std::string>>("targets"),
+               Equals(std::vector<std::string>{"a\tb", "\"\u65e5\""}));
+
+    std::ofstream(ini) << "name = \"\\U0001F600\\u00e9\"\n";
+    parser.config_file(ini);
+    res = parse({});
+    REQUIRE(res);
+    CHECK(res->get<std::string>("name") == "\U0001F600\u00e9");
+
+    for (const char *text : {R"({"name": "\u00"})", R"({"name": "\ud83d"})",
+                             R"({"name": "\udc00"})", R"({"name": "\x41"})",
+                             R"({"name": "\ud83d\u0041"})"}) {
+      std::ofstream(bad) << text;
+      parser.config_file(bad);
+      const ParseError error = parse({}).error();
+      CHECK(error.code() == ErrorCode::config_file);
+      CHECK(error.message().find("escape sequence") != std::string::npos);
+    }
+  }
+
+  std::filesystem::remove(ini);
+  std::filesystem::remove(json);
+  std::filesystem::remove(bad);
+}
@@ -0,0 +1,130 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <argparse/argparse.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace argparse;
+
+namespace {
+class Recorder : public Observer {
+public:
+  void record(const Event &event) override {
+    events.push_back({event.kind, std::string{event.parser},
+                      std::string{event.argument}, event.count,
+                      event.allocations});
+  }
+
+  std::size_t count(Event::Kind kind, std::string_view argument = {}) const {
+    std::size_t res = 0;
+    for (const auto &event : events)
+      if (event.kind == kind &&
+          (argument.empty() || event.argument == argument))
+        ++res;
+    return res;
+  }
+
+  struct Entry {
+    Event::Kind kind;
+    std::string parser, argument;
+    std::size_t count, allocations;
+  };
+  std::vector<Entry> events;
+};
+} // namespace
+
+TEST_CASE("observers see every parse phase") {
+  Recorder recorder;
+  ArgumentParser parser("test");
+  parser.observer(&recorder);
+  parser.add_argument<int>("-j", "--jobs");
+  parser.add_argument<std::vector<int>>("--ids");
+  parser.add_argument<std::string>("input");
+  CHECK(recorder.count(Event::add_argument) == 3);
+  CHECK(recorder.count(Event::add_argument, "--jobs") == 1);
+
+  const char *argv[] = {"test", "in.txt", "-j", "4", "--ids", "1,2", "3"};
+  Result res = parser.parse_args(7, argv);
+  CHECK(res.get<int>("jobs") == 4);
+  CHECK(recorder.count(Event::compile) == 1);
+  CHECK(recorder.count(Event::parse) == 1);
+  CHECK(recorder.count(Event::validate) == 1);
+  CHECK(recorder.count(Event::collect) == 1);
+  CHECK(recorder.count(Event::convert, "--jobs") == 1);
+  CHECK(recorder.count(Event::convert, "--ids") == 2);
+  CHECK(recorder.count(Event::convert, "input") == 1);
+
+  parser.parse_args(7, argv);
+  CHECK(recorder.count(Event::compile) == 1);
+  CHECK(recorder.count(Event::parse) == 2);
+
+  parser.help();
+  parser.usage();
+  CHECK(recorder.count(Event::help) == 1);
+
+  parser.observer(nullptr);
+  const std::size_t before = recorder.events.size();
+  parser.parse_args(7, argv);
+  CHECK(recorder.events.size() == before);
+}
+
+TEST_CASE("observers follow subcommands") {
+  Recorder recorder;
+  ArgumentParser parser("test");
+  parser.add_subcommand("build", "build the project",
+                        [](ArgumentParser &build) {
+                          build.add_argument<int>("-j", "--jobs");
+                        });
+  parser.observer(&recorder);
+
+  const char *argv[] = {"test", "build", "-j", "2"};
+  parser.parse_args(4, argv);
+  CHECK(recorder.count(Event::add_argument, "--jobs") == 1);
+  CHECK(recorder.count(Event::convert, "--jobs") == 1);
+  CHECK(recorder.count(Event::validate) == 2);
+  for (const auto &event : recorder.events)
+    if (event.kind == Event::convert)
+      CHECK(event.parser == "build");
+}
+
+TEST_CASE("parse events count allocations") {
+  Recorder recorder;
+  ArgumentParser parser("test");
+  parser.add_argument<std::vector<std::string>>("inputs");
+  parser.observer(&recorder);
+
+  CountingResource counting;
+  const char *argv[] = {"test", "a", "b", "c"};
+  TypedResult res = parser.parse_typed(4, argv, &counting);
+  CHECK(counting.allocations() > 0);
+  REQUIRE(recorder.count(Event::parse) == 1);
+  for (const auto &event : recorder.events)
+    if (event.kind == Event::parse)
+      CHECK(event.allocations == counting.allocations());
+}
+
+TEST_CASE("chrome trace writes complete events") {
+  ChromeTrace trace;
+  ArgumentParser parser("test \"quoted\"");
+  parser.observer(&trace);
+  parser.add_argument<int>("-j", "--jobs");
+
+  const char *argv[] = {"test", "-j", "4"};
+  parser.parse_args(3, argv);
+  CHECK(trace.size() > 0);
+
+  std::ostringstream out;
+  trace.write(out);
+  const std::string json = out.str();
+  CHECK(json.rfind("{\"traceEvents\":[", 0) == 0);
+  CHECK(json.find("\"ph\":\"X\"") != std::string::npos);
+  CHECK(json.find("\"cat\":\"convert\"") != std::string::npos);
+  CHECK(json.find("\"name\":\"--jobs\"") != std::string::npos);
+  CHECK(json.find("test \\\"quoted\\\"") != std::string::npos);
+  CHECK(json.substr(json.size() - 3) == "]}\n");
+
+  trace.clear();
+  CHECK(trace.size() == 0);
+}
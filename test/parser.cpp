@@ -19,3 +19,142 @@ TEST_CASE("parser") {
     CHECK(parse<std::optional<int>>("") == std::optional<int>{});
   }
 }
+
+TEST_CASE("parse lists") {
+  CHECK(parse<std::vector<int>>("").empty());
+  CHECK_THAT(parse<std::vector<int>>("1"), Equals(std::vector<int>{1}));
+  CHECK_THAT(parse<std::vector<int>>("1,2,"), Equals(std::vector<int>{1, 2}));
+  CHECK_THAT(parse<std::vector<std::string>>(",a"),
+             Equals(std::vector<std::string>{"", "a"}));
+  CHECK_THAT(parse<std::vector<bool>>("true,0"),
+             Equals(std::vector<bool>{true, false}));
+
+  std::vector<int> value{7};
+  parse("1;2 3", value, "; ");
+  CHECK_THAT(value, Equals(std::vector<int>{7, 1, 2, 3}));
+  CHECK_THROWS_AS(parse("4,x", value), argument_incorrect_type);
+  CHECK_THAT(value, Equals(std::vector<int>{7, 1, 2, 3, 4}));
+
+  std::vector<std::string> paths;
+  parse("a,b", paths, "");
+  CHECK_THAT(paths, Equals(std::vector<std::string>{"a,b"}));
+
+  const std::string_view tokens[] = {"", "1,2"};
+  std::vector<int> sequential, parallel;
+  for (const auto token : tokens)
+    parse(token, sequential);
+  parse_parallel(tokens, 2, parallel, ",", 2);
+  CHECK_THAT(sequential, Equals(std::vector<int>{1, 2}));
+  CHECK_THAT(parallel, Equals(sequential));
+
+  const std::string_view trailing[] = {"1,2,", "3,"};
+  parallel.clear();
+  parse_parallel(trailing, 2, parallel, ",", 2);
+  CHECK_THAT(parallel, Equals(std::vector<int>{1, 2, 3}));
+}
+
+TEST_CASE("parse booleans") {
+  STATIC_REQUIRE(argparse::detail::is_truthy("true"));
+  STATIC_REQUIRE(argparse::detail::is_falsy("False"));
+  STATIC_REQUIRE_FALSE(argparse::detail::is_truthy("yes"));
+
+  for (const char *text : {"1", "t", "T", "true", "True"})
+    CHECK(parse<bool>(text));
+  for (const char *text : {"0", "f", "F", "false", "False"})
+    CHECK_FALSE(parse<bool>(text));
+  for (const char *text : {"", "tru", "TRUE", "yes", "10", "true "})
+    CHECK_THROWS_AS(parse<bool>(text), argument_incorrect_type);
+}
+
+TEST_CASE("try_parse reports failures without throwing") {
+  int value = 7;
+  CHECK(try_parse("42", value));
+  CHECK(value == 42);
+  CHECK_FALSE(try_parse("4x", value));
+  CHECK(value == 42);
+
+  double real = 0;
+  CHECK(try_parse("-1.5", real));
+  CHECK(real == Approx(-1.5));
+  CHECK_FALSE(try_parse("", real));
+
+  std::vector<int> list{1};
+  CHECK_FALSE(try_parse("2,x,3", list));
+  CHECK_THAT(list, Equals(std::vector<int>{1, 2}));
+
+  std::optional<bool> flag;
+  CHECK(try_parse("", flag));
+  CHECK_FALSE(flag.has_value());
+  CHECK_FALSE(try_parse("maybe", flag));
+}
+
+TEMPLATE_TEST_CASE("parse integers", "", std::int8_t, std::int32_t,
+                   std::int64_t, std::uint8_t, std::uint32_t, std::uint64_t) {
+  SECTION("bases") {
+    CHECK(parse<TestType>("0") == TestType{0});
+    CHECK(parse<TestType>("42") == TestType{42});
+    CHECK(parse<TestType>("0x2a") == TestType{42});
+    CHECK(parse<TestType>("0X2A") == TestType{42});
+    CHECK(parse<TestType>("052") == TestType{42});
+    CHECK(parse<TestType>("0b101010") == TestType{42});
+  }
+
+  SECTION("sign") {
+    if constexpr (std::is_signed<TestType>::value) {
+      CHECK(parse<TestType>("-42") == TestType{-42});
+      CHECK(parse<TestType>("-0x2a") == TestType{-42});
+      CHECK(parse<TestType>("-0") == TestType{0});
+    } else {
+      CHECK_THROWS_AS(parse<TestType>("-42"), argument_incorrect_type);
+    }
+    CHECK_THROWS_AS(parse<TestType>("+42"), argument_incorrect_type);
+  }
+
+  SECTION("limits") {
+    using limits = std::numeric_limits<TestType>;
+    CHECK(parse<TestType>(std::to_string(limits::max())) == limits::max());
+    CHECK(parse<TestType>(std::to_string(limits::min())) == limits::min());
+    CHECK_THROWS_AS(parse<TestType>(std::to_string(limits::max()) + "0"),
+                    argument_incorrect_type);
+    CHECK_THROWS_AS(parse<TestType>("99999999999999999999999"),
+                    argument_incorrect_type);
+  }
+
+  SECTION("malformed") {
+    CHECK_THROWS_AS(parse<TestType>(""), argument_incorrect_type);
+    CHECK_THROWS_AS(parse<TestType>("-"), argument_incorrect_type);
+    CHECK_THROWS_AS(parse<TestType>("0x"), argument_incorrect_type);
+    CHECK_THROWS_AS(parse<TestType>("0b"), argument_incorrect_type);
+    CHECK_THROWS_AS(parse<TestType>("08"), argument_incorrect_type);
+    CHECK_THROWS_AS(parse<TestType>("0b102"), argument_incorrect_type);
+    CHECK_THROWS_AS(parse<TestType>("12a"), argument_incorrect_type);
+    CHECK_THROWS_AS(parse<TestType>(" 12"), argument_incorrect_type);
+  }
+}
+
+TEMPLATE_TEST_CASE("parse floating point", "", float, double, long double) {
+  SECTION("decimal") {
+    CHECK(parse<TestType>("1.5") == Approx(1.5));
+    CHECK(parse<TestType>("-2.25e2") == Approx(-225.0));
+    CHECK(parse<TestType>("+.5") == Approx(0.5));
+    CHECK(parse<TestType>("3") == Approx(3.0));
+  }
+
+  SECTION("hexadecimal") {
+    CHECK(parse<TestType>("0x1p4") == Approx(16.0));
+    CHECK(parse<TestType>("-0X1.8p1") == Approx(-3.0));
+  }
+
+  SECTION("special values") {
+    CHECK(std::isinf(parse<TestType>("inf")));
+    CHECK(parse<TestType>("-infinity") < 0);
+    CHECK(std::isnan(parse<TestType>("nan")));
+    CHECK(std::isnan(parse<TestType>("NaN")));
+  }
+
+  SECTION("malformed") {
+    for (const char *text : {"", "-", "0x", "1.5abc", " 1.5", "1.5 ", "--1",
+                             "+-1", "1e99999", "abc", "0x1.8p1x"})
+      CHECK_THROWS_AS(parse<TestType>(text), argument_incorrect_type);
+  }
+}
@@ -103,3 +103,129 @@ TEMPLATE_TEST_CASE("result explicit casts", "", bool, char, int, unsigned int,
     CHECK_THROWS_AS(res.get<std::string>("c"), std::out_of_range);
   }
 }
+
+TEST_CASE("typed result lookups through handles") {
+  ArgumentParser parser("test");
+  ArgHandle<int> jobs = parser.add_argument<int>("-j", "--jobs");
+  auto verbose        = parser.add_argument("-v", "--verbose").handle();
+  ArgHandle<std::vector<std::string>> inputs =
+      parser.add_argument<std::vector<std::string>>("inputs");
+  ArgHandle<double> scale = parser.add_argument<double>("--scale");
+  ArgHandle<int> level;
+  parser.add_subcommand("build", "build the project");
+
+  const char *argv[] = {"test", "-v", "-j", "4", "a", "b"};
+  TypedResult res    = parser.parse_typed(6, argv);
+
+  CHECK(res.command() == "test");
+  CHECK(res.get(jobs) == 4);
+  CHECK(res.count(jobs) == 1);
+  CHECK(res.get(verbose));
+  CHECK(res.get(inputs) == std::vector<std::string>{"a", "b"});
+  CHECK_FALSE(res.has(scale));
+  CHECK_THROWS_AS(res.get(scale), std::out_of_range);
+  CHECK_FALSE(res.has(level));
+  CHECK(res.subcommand() == nullptr);
+
+  TypedResult copy = res;
+  res.clear();
+  CHECK_FALSE(res.has(inputs));
+  CHECK(copy.get(inputs) == std::vector<std::string>{"a", "b"});
+}
+
+TEST_CASE("typed result subcommands") {
+  ArgumentParser parser("test");
+  ArgHandle<int> jobs = parser.add_subcommand("build", "build the project")
+                            .add_argument<int>("-j", "--jobs")
+                            .default_value(2);
+
+  const char *argv[] = {"test", "build"};
+  TypedResult res    = parser.parse_typed(2, argv);
+  REQUIRE(res.subcommand() != nullptr);
+  CHECK(res.subcommand()->command() == "build");
+  CHECK(res.get(jobs) == 2);
+  CHECK(res.count(jobs) == 0);
+}
+
+TEST_CASE("result owns its keys") {
+  Result res;
+  {
+    std::string key = "temporary";
+    res.insert(key, 7);
+    res.insert(std::string("other"), 8);
+    key.assign("overwritten");
+  }
+  res.insert("temporary", 9);
+
+  Result copy = res;
+  res         = Result{};
+  CHECK(copy.get<int>("temporary") == 7);
+  CHECK(copy.get<int>("other") == 8);
+  CHECK_FALSE(res.has("temporary"));
+}
+
+TEST_CASE("result lookups through handles") {
+  ArgumentParser parser("test");
+  ArgHandle<int> jobs = parser.add_argument<int>("-j", "--jobs");
+  ArgHandle<bool> verbose =
+      parser.add_subcommand("build", "build the project")
+          .add_argument("-v", "--verbose");
+  ArgHandle<double> scale = parser.add_argument<double>("--scale");
+
+  const char *argv[] = {"test", "--jobs", "3", "build", "-v"};
+  Result res         = parser.parse_args(5, argv);
+  CHECK(res.get(jobs) == 3);
+  CHECK(res[jobs] == 3);
+  CHECK(res.count(jobs) == 1);
+  CHECK(res.get(verbose));
+  CHECK(res.has("build"));
+  CHECK_FALSE(res.has(scale));
+  CHECK_THROWS_AS(res[scale], std::out_of_range);
+  CHECK_FALSE(res.has(ArgHandle<int>{}));
+}
+
+TEST_CASE("results allocate from a memory resource") {
+  ArgumentParser parser("test");
+  ArgHandle<int> jobs = parser.add_argument<int>("-j", "--jobs");
+  ArgHandle<std::vector<int>> ids =
+      parser.add_subcommand("build", "build the project")
+          .add_argument<std::vector<int>>("--ids");
+  parser.add_argument<std::string>("input");
+
+  const char *argv[] = {"test", "-j", "3", "in.txt", "build", "--ids", "1,2"};
+  alignas(std::max_align_t) std::byte buffer[4096];
+  std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer),
+                                            std::pmr::null_memory_resource());
+
+  SECTION("typed results") {
+    TypedResult res = parser.parse_typed(7, argv, &arena);
+    CHECK(res.resource() == &arena);
+    CHECK(res.get(jobs) == 3);
+    CHECK(res.get(ids) == std::vector<int>{1, 2});
+
+    TypedResult copy = res;
+    CHECK(copy.resource() == std::pmr::get_default_resource());
+    CHECK(copy.get(ids) == std::vector<int>{1, 2});
+    res = std::move(copy);
+    CHECK(res.resource() == &arena);
+    CHECK(res.get(jobs) == 3);
+  }
+
+  SECTION("results") {
+    Result res = parser.parse_args(7, argv, &arena);
+    CHECK(res.get<int>("jobs") == 3);
+    CHECK(res.get<std::string>("input") == "in.txt");
+    CHECK(res.get(ids) == std::vector<int>{1, 2});
+
+    const char *other_argv[] = {"test", "-j", "5", "out.txt"};
+    const Result other       = parser.parse_args(4, other_argv);
+    std::pmr::memory_resource *heap =
+        std::pmr::set_default_resource(std::pmr::null_memory_resource());
+    res = other;
+    std::pmr::set_default_resource(heap);
+    CHECK(res.resource() == &arena);
+    CHECK(res.get<int>("jobs") == 5);
+    CHECK(res.get<std::string>("input") == "out.txt");
+    CHECK_FALSE(res.has("ids"));
+  }
+}
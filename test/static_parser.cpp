@@ -0,0 +1,62 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_vector.hpp>
+
+#include <argparse/argparse.hpp>
+
+using namespace argparse;
+using namespace Catch;
+using namespace Catch::Matchers;
+
+namespace {
+struct Options {
+  bool verbose = false;
+  int jobs     = 1;
+  std::string output;
+  std::vector<int> inputs;
+};
+
+constexpr auto parser = make_parser<Options>(
+    "test", field<&Options::verbose>("-v", "--verbose").help("verbose output"),
+    field<&Options::jobs>("--jobs", "-j"), field<&Options::output>("-o"),
+    field<&Options::inputs>("inputs"));
+} // namespace
+
+TEST_CASE("static parser specification") {
+  STATIC_REQUIRE(parser.program_name() == "test");
+  STATIC_REQUIRE(parser.find("-j") == 1);
+  STATIC_REQUIRE(parser.find("--jobs") == 1);
+  STATIC_REQUIRE(parser.find("--verbose") == 0);
+  STATIC_REQUIRE(parser.find("--missing") == parser.npos);
+  STATIC_REQUIRE(parser.usage().view() ==
+                 "Usage: test [--jobs JOBS] [--verbose] [-o O] INPUTS "
+                 "[INPUTS ...]");
+}
+
+TEST_CASE("static parser parse arguments") {
+  SECTION("options and positionals") {
+    const char *argv[] = {"test", "-v", "--jobs=4", "-o", "out", "1", "2,3"};
+    const Options opts = parser.parse_args(7, argv);
+    CHECK(opts.verbose);
+    CHECK(opts.jobs == 4);
+    CHECK(opts.output == "out");
+    CHECK_THAT(opts.inputs, Equals(std::vector<int>{1, 2, 3}));
+  }
+
+  SECTION("defaults") {
+    const char *argv[] = {"test", "--", "-1"};
+    const Options opts = parser.parse_args(3, argv);
+    CHECK_FALSE(opts.verbose);
+    CHECK(opts.jobs == 1);
+    CHECK(opts.output.empty());
+    CHECK_THAT(opts.inputs, Equals(std::vector<int>{-1}));
+  }
+
+  SECTION("errors") {
+    const char *missing[] = {"test", "-v"};
+    CHECK_THROWS_AS(parser.parse_args(2, missing), ParseException);
+    const char *unknown[] = {"test", "--unknown", "1"};
+    CHECK_THROWS_AS(parser.parse_args(3, unknown), ParseException);
+    const char *value[] = {"test", "1", "-j"};
+    CHECK_THROWS_AS(parser.parse_args(3, value), ParseException);
+  }
+}
@@ -0,0 +1,142 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_vector.hpp>
+
+#include <argparse/argparse.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace argparse;
+using namespace Catch::Matchers;
+
+namespace {
+std::vector<std::string> split(Tokenizer &tokenizer, std::string_view line) {
+  const auto &tokens = tokenizer(line);
+  return {tokens.begin(), tokens.end()};
+}
+
+bool is_slice(std::string_view token, std::string_view line) {
+  return token.data() >= line.data() &&
+         token.data() + token.size() <= line.data() + line.size();
+}
+
+std::string quote(const std::string &token, int style) {
+  std::string res;
+  if (style == 0) {
+    res += '\'';
+    for (char c : token)
+      res += c == '\'' ? std::string{"'\\''"} : std::string(1, c);
+    res += '\'';
+  } else if (style == 1) {
+    res += '"';
+    for (char c : token) {
+      if (c == '"' || c == '\\' || c == '$' || c == '`')
+        res += '\\';
+      res += c;
+    }
+    res += '"';
+  } else {
+    for (char c : token) {
+      if (c == '\n') {
+        res += "'\n'";
+        continue;
+      } else if (c == ' ' || c == '\t' || c == '\'' || c == '"' ||
+                 c == '\\') {
+        res += '\\';
+      }
+      res += c;
+    }
+    if (res.empty())
+      res = "''";
+  }
+  return res;
+}
+} // namespace
+
+TEST_CASE("tokenize whitespace separated words") {
+  Tokenizer tokenizer;
+  CHECK(split(tokenizer, "").empty());
+  CHECK(split(tokenizer, " \t\n ").empty());
+  CHECK_THAT(split(tokenizer, "  build  -j 4\t--verbose\n"),
+             Equals(std::vector<std::string>{"build", "-j", "4", "--verbose"}));
+  CHECK_THAT(split(tokenizer, "a -- -b"),
+             Equals(std::vector<std::string>{"a", "--", "-b"}));
+}
+
+TEST_CASE("tokenize quotes and escapes") {
+  Tokenizer tokenizer;
+  CHECK_THAT(split(tokenizer, "'a b' \"c d\" e\\ f"),
+             Equals(std::vector<std::string>{"a b", "c d", "e f"}));
+  CHECK_THAT(split(tokenizer, "'' \"\" x''"),
+             Equals(std::vector<std::string>{"", "", "x"}));
+  CHECK_THAT(split(tokenizer, "'a\\b' \"a\\b\" a\\b"),
+             Equals(std::vector<std::string>{"a\\b", "a\\b", "ab"}));
+  CHECK_THAT(split(tokenizer, "\"\\\"\\\\\\$\\`\" \"it's\" 'say \"hi\"'"),
+             Equals(std::vector<std::string>{"\"\\$`", "it's", "say \"hi\""}));
+  CHECK_THAT(split(tokenizer, "--name='John Smith' pre\"fix\"post"),
+             Equals(std::vector<std::string>{"--name=John Smith",
+                                             "prefixpost"}));
+  CHECK_THAT(split(tokenizer, "one\\\ntwo \"three\\\nfour\""),
+             Equals(std::vector<std::string>{"onetwo", "threefour"}));
+}
+
+TEST_CASE("tokenize slices the input where possible") {
+  Tokenizer tokenizer;
+  const std::string line = "plain 'single quoted' \"double \\q\" esc\\ aped";
+  const auto &tokens     = tokenizer(line);
+  REQUIRE(tokens.size() == 4);
+  CHECK(is_slice(tokens[0], line));
+  CHECK(is_slice(tokens[1], line));
+  CHECK(is_slice(tokens[2], line));
+  CHECK_FALSE(is_slice(tokens[3], line));
+  CHECK(tokens[2] == "double \\q");
+  CHECK(tokens[3] == "esc aped");
+}
+
+TEST_CASE("tokenize rejects unterminated input") {
+  Tokenizer tokenizer;
+  CHECK_THROWS_AS(tokenizer("a 'b"), ParseException);
+  CHECK_THROWS_AS(tokenizer("a \"b"), ParseException);
+  CHECK_THROWS_AS(tokenizer("a \"b\\"), ParseException);
+  CHECK_THROWS_AS(tokenizer("a b\\"), ParseException);
+}
+
+TEST_CASE("tokenize random quoted lines") {
+  const std::string alphabet = "ab -=\t\n'\"\\$`xyz";
+  std::mt19937 rng(0x5eed);
+  std::uniform_int_distribution<std::size_t> letter(0, alphabet.size() - 1);
+  std::uniform_int_distribution<std::size_t> length(0, 40);
+  std::uniform_int_distribution<int> style(0, 2);
+  std::uniform_int_distribution<std::size_t> count(0, 12);
+
+  Tokenizer tokenizer;
+  for (int round = 0; round < 2000; ++round) {
+    std::vector<std::string> expected;
+    std::string line;
+    for (std::size_t i = count(rng); i > 0; --i) {
+      std::string token;
+      for (std::size_t j = length(rng); j > 0; --j)
+        token += alphabet[letter(rng)];
+      line += quote(token, style(rng));
+      line.append(1 + i % 3, ' ');
+      expected.push_back(std::move(token));
+    }
+    CAPTURE(line);
+    CHECK_THAT(split(tokenizer, line), Equals(expected));
+  }
+}
+
+TEST_CASE("tokenized lines feed the parser") {
+  ArgumentParser parser("test");
+  parser.add_argument<std::string>("-m", "--message");
+  parser.add_argument<std::vector<std::string>>("files");
+  parser.freeze();
+
+  Tokenizer tokenizer;
+  Result res;
+  parser.parse(tokenizer("-m 'hello world' a\\ b.txt \"c.txt\""), res);
+  CHECK(res.get<std::string>("message") == "hello world");
+  CHECK_THAT(res.get<std::vector<std::string>>("files"),
+             Equals(std::vector<std::string>{"a b.txt", "c.txt"}));
+}
@@ -0,0 +1,81 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <argparse/argparse.hpp>
+
+#include <random>
+#include <string>
+#include <string_view>
+
+using argparse::detail::display_width;
+using argparse::detail::wrap;
+
+namespace {
+std::size_t widest_line(std::string_view text) {
+  std::size_t widest = 0, prev = 0, pos = 0;
+  while ((pos = text.find('\n', prev)) != std::string_view::npos) {
+    widest = std::max(widest, display_width(text.substr(prev, pos - prev)));
+    prev   = pos + 1;
+  }
+  return std::max(widest, display_width(text.substr(prev)));
+}
+
+std::string strip_whitespace(std::string_view text) {
+  std::string res;
+  for (char c : text)
+    if (c != ' ' && c != '\t' && c != '\n')
+      res += c;
+  return res;
+}
+} // namespace
+
+TEST_CASE("display width") {
+  STATIC_REQUIRE(display_width("hello") == 5);
+  CHECK(display_width("") == 0);
+  CHECK(display_width("héllo") == 5);
+  CHECK(display_width("é") == 1);
+  CHECK(display_width("日本語") == 6);
+  CHECK(display_width("\U0001F600") == 2);
+  CHECK(display_width("\U0001F468‍\U0001F469") == 2);
+  CHECK(display_width("\xff") == 1);
+}
+
+TEST_CASE("wrap text") {
+  CHECK(wrap("the quick brown fox", 0, 0, 10) == "the quick\nbrown fox");
+  CHECK(wrap("the quick brown fox", 2, 0, 10) == "the quick\n  brown\n  fox");
+  CHECK(wrap("first\nsecond line", 4, 0, 80) == "first\n    second line");
+  CHECK(wrap("a  b", 0, 0, 80) == "a  b");
+  CHECK(wrap("abcdefghij", 0, 0, 4) == "abcd\nefgh\nij");
+  CHECK(wrap("go abcdefghij", 2, 0, 6) == "go\n  abcd\n  efgh\n  ij");
+  CHECK(wrap("日本語 日本語", 0, 0, 8) == "日本語\n日本語");
+  CHECK(wrap("héllo wörld", 0, 0, 11) == "héllo wörld");
+
+  std::string wide(400, 'x');
+  CHECK(wrap("a " + wide, 260, 0, 400) ==
+        "a\n" + std::string(260, ' ') + std::string(140, 'x') + "\n" +
+            std::string(260, ' ') + std::string(140, 'x') + "\n" +
+            std::string(260, ' ') + std::string(120, 'x'));
+}
+
+TEST_CASE("wrap random text") {
+  const std::string_view pieces[] = {
+      "a", "lorem", "ipsum", " ", " ", "  ", "\t", "\n", "été", "日", "é",
+      "\U0001F600", "supercalifragilisticexpialidocious"};
+  std::mt19937 rng(0x5eed);
+  std::uniform_int_distribution<std::size_t> piece(0, std::size(pieces) - 1);
+  std::uniform_int_distribution<std::size_t> length(0, 200);
+  std::uniform_int_distribution<std::size_t> columns(4, 120);
+
+  for (int round = 0; round < 2000; ++round) {
+    std::string text;
+    for (std::size_t i = length(rng); i > 0; --i)
+      text += pieces[piece(rng)];
+    const std::size_t width  = columns(rng);
+    const std::size_t indent =
+        std::uniform_int_distribution<std::size_t>(0, width - 2)(rng);
+
+    const std::string res = wrap(text, indent, indent, width);
+    CAPTURE(text, width, indent);
+    CHECK(widest_line(res) <= width);
+    CHECK(strip_whitespace(res) == strip_whitespace(text));
+  }
+}